@@ -0,0 +1,21 @@
+/**
+ * @file include/base/atomic.h
+ *
+ * Minimal wrappers around the compiler's atomic built-ins, for values shared
+ * between the main loop and other threads (e.g., the asset loader).
+ */
+#ifndef __BASE_ATOMIC_H__
+#define __BASE_ATOMIC_H__
+
+/** Read a value written by another thread. Every write done by that thread
+ * before its matching ATOMIC_STORE is visible after this returns. */
+#define ATOMIC_LOAD(pVal) __atomic_load_n((pVal), __ATOMIC_ACQUIRE)
+
+/** Publish a value to another thread, after every previous write. */
+#define ATOMIC_STORE(pVal, val) __atomic_store_n((pVal), (val), __ATOMIC_RELEASE)
+
+/** Add to a value shared with other threads, retrieving its previous value. */
+#define ATOMIC_FETCH_ADD(pVal, val) \
+    __atomic_fetch_add((pVal), (val), __ATOMIC_ACQ_REL)
+
+#endif /* __BASE_ATOMIC_H__ */
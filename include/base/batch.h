@@ -0,0 +1,125 @@
+/**
+ * @file include/base/batch.h
+ *
+ * Run many headless simulations in parallel, each replaying a recorded input
+ * from a given level, and report how each of them went.
+ *
+ * Jobs are listed on a text file, one per line, as the level followed by the
+ * recording (e.g., "lab/awakening_passage tests/intro.rec"). Empty lines and
+ * lines starting with '#' are ignored.
+ *
+ * Every worker runs on its own thread (and, thus, on its own simulation; see
+ * base/simulation.h), taking the next pending job as soon as it finishes the
+ * previous one. The spritesets are still loaded by the main thread, so a
+ * window is still created (although nothing is ever drawn into it).
+ */
+#ifndef __BASE_BATCH_H__
+#define __BASE_BATCH_H__
+
+#include <base/error.h>
+#include <base/game.h>
+
+#include <GFraMe/gframe.h>
+#include <GFraMe/gfmCamera.h>
+
+#include <stdint.h>
+
+#if defined(__WIN32) || defined(__WIN32__)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+/** Maximum number of threads running simulations */
+#define BATCH_MAX_WORKERS   64
+
+/** A single simulation and its results */
+struct stBatchJob {
+    /** Level where the simulation starts */
+    char *pLevel;
+    /** Recording replayed by the simulation */
+    char *pReplay;
+    /** Whether the simulation ran until the end of the recording */
+    err result;
+    /** First frame that didn't match the recording (-1 if none) */
+    int32_t divergedAt;
+    /** How many frames were simulated */
+    uint32_t frames;
+    /** Hash of the simulation's state after the last frame */
+    uint32_t hash;
+    /** Time spent simulating every frame, in microseconds */
+    uint64_t totalUs;
+    /** Time spent on the slowest frame, in microseconds */
+    uint64_t maxUs;
+};
+typedef struct stBatchJob batchJob;
+
+/** A thread running jobs */
+struct stBatchWorker {
+    /** The worker's GFraMe context (without a window) */
+    gfmCtx *pCtx;
+    /** The context's camera */
+    gfmCamera *pCamera;
+#if defined(__WIN32) || defined(__WIN32__)
+    HANDLE hThread;
+#else
+    pthread_t thread;
+#endif
+    /** Whether the thread was started (and, thus, must be joined) */
+    int isRunning;
+};
+typedef struct stBatchWorker batchWorker;
+
+struct stBatchCtx {
+    /** Every job, in the order they were listed */
+    batchJob *pJobs;
+    /** Contents of the job list (referenced by each job) */
+    char *pText;
+    /** The workers */
+    batchWorker pWorkers[BATCH_MAX_WORKERS];
+    /** Number of jobs */
+    int count;
+    /** Number of workers */
+    int workers;
+    /** Next job to be run (shared by every worker) */
+    int next;
+    /** Flags set on every simulation */
+    gameFlags flags;
+};
+typedef struct stBatchCtx batchCtx;
+
+/** The batch runner. Declared on src/base/static.c. */
+extern batchCtx batch;
+
+/**
+ * Load the list of jobs.
+ *
+ * @param  [ in]pPath   The job list
+ * @param  [ in]workers How many workers should be used (0 uses one for each
+ *                      core)
+ */
+err initBatch(char *pPath, int workers);
+
+/** Release every job */
+void freeBatch();
+
+/**
+ * Run every job and report the results.
+ *
+ * @return ERR_OK if every job replayed its recording without diverging,
+ *         ERR_BATCHFAILED otherwise
+ */
+err runBatch();
+
+/**
+ * Run a single job on the current thread. The thread's GFraMe context must have
+ * already been set on game.
+ *
+ * Different from the other functions on this module, this one is declared on
+ * src/batch.c, since it's specific to the game.
+ *
+ * @param  [ in]pJob The job
+ */
+err simulateBatchJob(batchJob *pJob);
+
+#endif /* __BASE_BATCH_H__ */
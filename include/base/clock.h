@@ -0,0 +1,23 @@
+/**
+ * @file include/base/clock.h
+ *
+ * Monotonic, high resolution clock used to measure how long each part of a
+ * frame takes. Also implements a sleep that doesn't depend on the game's timer.
+ */
+#ifndef __BASE_CLOCK_H__
+#define __BASE_CLOCK_H__
+
+#include <stdint.h>
+
+/** Retrieve the current time, in microseconds, since an unspecified point */
+uint64_t clockGetUs();
+
+/**
+ * Block the current thread for (about) the requested time.
+ *
+ * @param  [ in]us Time to sleep, in microseconds
+ */
+void clockSleepUs(uint64_t us);
+
+#endif /* __BASE_CLOCK_H__ */
+
@@ -7,6 +7,7 @@
  *  --backend | -b: Set the video backend {OpenGL, SDL, Software}
  *  --pixel-resolution | -x: Set the initial upcaling factor
  *  --FPS | -F: Set the game's initial (and maximum) FPS
+ *  --max-frameskip | -m: Set how many draws may be skipped in a row
  *  --resolution | -r: Set which resolution is to be used on fullscreen mode
  *  --audio | -a: *TODO* Set the audio quality
  *  --vsync | -v: Enable VSync
@@ -5,6 +5,7 @@
 #define __BASE_COLLISION_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 
 #include <GFraMe/gfmQuadtree.h>
 
@@ -25,13 +26,16 @@ struct stCollisionCtx {
     gfmQuadtreeRoot *pQt;
     /** Static quadtree's root */
     gfmQuadtreeRoot *pStaticQt;
+    /** Number of overlapping pairs handled (reset by the performance overlay,
+     * every update) */
+    int pairs;
     /** Controls the collision */
     collisionFlags flags;
 };
 typedef struct stCollisionCtx collisionCtx;
 
 /** Collision context. Declared on src/base/static.c. */
-extern collisionCtx collision;
+extern SIM_LOCAL collisionCtx collision;
 
 /** Setup the collision context */
 err setupCollision();
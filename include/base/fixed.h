@@ -0,0 +1,70 @@
+/**
+ * @file include/base/fixed.h
+ *
+ * 16.16 fixed-point numbers. Every operation is done on integers, so results
+ * are the same regardless of the compiler, the optimization level or the
+ * floating-point unit (e.g., whether multiply-adds get fused).
+ *
+ * Conversions to double are exact, so a fixed-point value may be stored on a
+ * double (e.g., a sprite's velocity) and later read back without any loss.
+ */
+#ifndef __BASE_FIXED_H__
+#define __BASE_FIXED_H__
+
+#include <stdint.h>
+
+/** A 16.16 fixed-point number */
+typedef int32_t fixed;
+
+/** Number of bits on the fractional part */
+#define FIXED_SHIFT     16
+/** 1.0, in fixed point */
+#define FIXED_ONE       ((fixed)1 << FIXED_SHIFT)
+
+/** Convert an integer into fixed point (multiplied, as shifting a negative
+ * value is undefined) */
+#define FIXED_FROM_INT(n)   ((fixed)(n) * FIXED_ONE)
+
+/**
+ * Convert a fixed-point number into the integer right below it (i.e., rounding
+ * towards negative infinity, just like the position of an object).
+ *
+ * @param  [ in]v The number
+ */
+static inline int fixedToInt(fixed v) {
+    if (v >= 0) {
+        return (int)(v / FIXED_ONE);
+    }
+    return -(int)((-(int64_t)v + FIXED_ONE - 1) / FIXED_ONE);
+}
+
+/**
+ * Multiply two fixed-point numbers (rounding towards zero).
+ *
+ * @param  [ in]a One of the numbers
+ * @param  [ in]b The other number
+ */
+static inline fixed fixedMul(fixed a, fixed b) {
+    return (fixed)(((int64_t)a * (int64_t)b) / FIXED_ONE);
+}
+
+/**
+ * Convert a double into fixed point (rounding towards zero). Since scaling by
+ * a power of two is exact, this is deterministic for any given double.
+ *
+ * @param  [ in]v The number
+ */
+static inline fixed fixedFromDouble(double v) {
+    return (fixed)(v * FIXED_ONE);
+}
+
+/**
+ * Convert a fixed-point number into a double (exactly).
+ *
+ * @param  [ in]v The number
+ */
+static inline double fixedToDouble(fixed v) {
+    return v / (double)FIXED_ONE;
+}
+
+#endif /* __BASE_FIXED_H__ */
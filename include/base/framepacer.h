@@ -0,0 +1,121 @@
+/**
+ * @file include/base/framepacer.h
+ *
+ * Governor that adapts the draw rate to how long updates and draws take.
+ *
+ * The cost of every update and of every draw is measured (and smoothed). If
+ * drawing would push a frame over its budget, the draw rate is lowered so
+ * several updates run for each draw (up to a configurable amount of skipped
+ * draws), keeping the simulation at a constant speed. When there's slack
+ * between frames, the game sleeps until (right before) the next frame instead
+ * of busy waiting for the next event.
+ *
+ * Lastly, states may report whether anything on screen changed. If nothing
+ * did, drawing is skipped and the previously presented frame is kept.
+ */
+#ifndef __BASE_FRAMEPACER_H__
+#define __BASE_FRAMEPACER_H__
+
+#include <base/error.h>
+
+#include <stdint.h>
+
+enum enFramePacerFlags {
+    /** Whether the draw rate may be lowered */
+    FP_SKIP_DRAWS = 0x01
+    /** Whether the game should sleep when there's slack */
+  , FP_SLEEP      = 0x02
+    /** Whether anything changed since the last draw */
+  , FP_DIRTY      = 0x04
+};
+typedef enum enFramePacerFlags framePacerFlags;
+
+struct stFramePacerCtx {
+    /** Time when the last update started, in microseconds */
+    uint64_t updateStart;
+    /** Time when the current draw started, in microseconds */
+    uint64_t drawStart;
+    /** Smoothed cost of a single update, in microseconds */
+    int updateCost;
+    /** Smoothed cost of a single draw, in microseconds */
+    int drawCost;
+    /** Cost of the last update, in microseconds */
+    int lastUpdate;
+    /** Cost of the last draw, in microseconds */
+    int lastDraw;
+    /** Time available for each update (i.e., a frame), in microseconds */
+    int budget;
+    /** Number of updates executed each second */
+    int fps;
+    /** How many updates are currently executed for each draw */
+    int updatesPerDraw;
+    /** Maximum number of draws that may be skipped in a row */
+    int maxFrameskip;
+    /** For how many draws a lower updates-per-draw ratio has been viable */
+    int settle;
+    /** How many updates were executed since the last draw */
+    int updateCount;
+    /** How many draws were skipped since the game started */
+    int skippedDraws;
+    /** How long the game slept on the last frame, in microseconds */
+    int sleptUs;
+    /** How many draws in a row were skipped because nothing changed */
+    int idleDraws;
+    /** How many draws were skipped because nothing changed, since the game
+     * started */
+    int idleSkipped;
+    framePacerFlags flags;
+};
+typedef struct stFramePacerCtx framePacerCtx;
+
+/** The frame pacer. Declared on src/base/static.c. */
+extern framePacerCtx pacer;
+
+/**
+ * Initialize the frame pacer. Must be called after the FPS is configured.
+ *
+ * @param  [ in]fps          Number of updates executed each second
+ * @param  [ in]maxFrameskip Maximum number of draws skipped in a row (0 disable
+ *                           skipping draws)
+ * @param  [ in]doSleep      Whether the game should sleep when there's slack
+ */
+err initFramePacer(int fps, int maxFrameskip, int doSleep);
+
+/** Mark the start of an update */
+void framePacerBeginUpdate();
+
+/** Mark the end of an update */
+void framePacerEndUpdate();
+
+/** Mark the start of a draw */
+void framePacerBeginDraw();
+
+/**
+ * Mark the end of a draw and, if required, adjust the draw rate based on the
+ * current costs.
+ */
+err framePacerEndDraw();
+
+/** Signal that something changed on screen and the next draw must happen */
+void markFrameDirty();
+
+/**
+ * Check whether the next draw should actually be rendered. If nothing changed
+ * since the last one, it's skipped (unless too many were skipped in a row, to
+ * refresh the window every now and then).
+ *
+ * @return 1 if the frame should be drawn, 0 otherwise
+ */
+int framePacerShouldDraw();
+
+/**
+ * If there's enough time before the next update, sleep until right before it.
+ * Should be called before waiting for events.
+ */
+void framePacerSleep();
+
+/** Render the governor's current state (for debugging) */
+void drawFramePacerInfo();
+
+#endif /* __BASE_FRAMEPACER_H__ */
+
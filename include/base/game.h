@@ -6,6 +6,7 @@
 #ifndef __BASE_GAME_H__
 #define __BASE_GAME_H__
 
+#include <base/simulation.h>
 #include <conf/state.h>
 
 #include <GFraMe/gframe.h>
@@ -26,6 +27,10 @@ enum enGameFlags {
   , CMD_CUSTOMINPUT = 0x04
   , FX_PRETTYRENDER = 0x08
   , CMD_LAZYLOAD    = 0x10
+  , CMD_NETPLAY     = 0x20
+  , CMD_BATCH       = 0x40
+  , CMD_HEADLESS    = 0x80
+  , CMD_BOT         = 0x100
 };
 typedef enum enGameFlags gameFlags;
 
@@ -45,6 +50,8 @@ struct stGameCtx {
     gameFlags flags;
     /** Flags recovered/saved for a given session/save file */
     enum enSessionFlags sessionFlags;
+    /** Level played by the bot's CLI (only if CMD_BOT is set) */
+    char *pBotLevel;
 #endif /* JJATENGINE */
     /** Fixed time elapsed since the last frame, in milliseconds. Note that even
      * though this should store a 'fixed' value, it may vary in a pre-determined
@@ -91,7 +98,7 @@ typedef struct stGameCtx gameCtx;
 #  define DEBUG_STEP()
 #endif
 
-extern gameCtx game;
+extern SIM_LOCAL gameCtx game;
 
 #endif /* __GAME_H__ */
 
@@ -0,0 +1,61 @@
+/**
+ * @file include/base/hash.h
+ *
+ * Simple and fast (non-cryptographic) hash, used to detect whether some state
+ * changed between frames. It's a plain FNV-1a, so values may be accumulated
+ * by chaining calls.
+ */
+#ifndef __BASE_HASH_H__
+#define __BASE_HASH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Initial value for any hash */
+#define HASH_INIT   2166136261u
+/** FNV-1a's 32 bits prime */
+#define HASH_PRIME  16777619u
+
+/**
+ * Accumulate a buffer into a hash
+ *
+ * @param  [ in]hash The current hash
+ * @param  [ in]pBuf The buffer
+ * @param  [ in]len  The buffer's length, in bytes
+ * @return           The updated hash
+ */
+static inline uint32_t hashBuf(uint32_t hash, const void *pBuf, size_t len) {
+    const uint8_t *pData = (const uint8_t*)pBuf;
+
+    while (len > 0) {
+        hash ^= *pData;
+        hash *= HASH_PRIME;
+        pData++;
+        len--;
+    }
+
+    return hash;
+}
+
+/**
+ * Accumulate an integer into a hash
+ *
+ * @param  [ in]hash The current hash
+ * @param  [ in]val  The value
+ * @return           The updated hash
+ */
+static inline uint32_t hashInt(uint32_t hash, uint32_t val) {
+    int i = 0;
+
+    while (i < 4) {
+        hash ^= val & 0xff;
+        hash *= HASH_PRIME;
+        val >>= 8;
+        i++;
+    }
+
+    return hash;
+}
+
+#endif /* __BASE_HASH_H__ */
+
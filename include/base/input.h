@@ -7,6 +7,7 @@
 #define __BASE_INPUT_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 #include <conf/input_list.h>
 
 #include <GFraMe/gfmInput.h>
@@ -35,7 +36,7 @@ struct stInputCtx {
 typedef struct stInputCtx inputCtx;
 
 /** Global input (declared on src/base/static.c) */
-extern inputCtx input;
+extern SIM_LOCAL inputCtx input;
 
 /**
  * Handle every input that require an immediate action (i.e, those that are more
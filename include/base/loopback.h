@@ -0,0 +1,90 @@
+/**
+ * @file include/base/loopback.h
+ *
+ * A local stand-in for a network transport. Packets sent on a channel are only
+ * received after an artificial latency, and some may be randomly lost (just
+ * like on an unreliable network).
+ *
+ * Time only advances when updateLoopback is called, so, given the same seed,
+ * the same packets are always lost.
+ */
+#ifndef __BASE_LOOPBACK_H__
+#define __BASE_LOOPBACK_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <stdint.h>
+
+/** Number of independent channels (e.g., one for each direction) */
+#define LOOPBACK_CHANNELS       2
+/** Maximum number of packets in flight on each channel */
+#define LOOPBACK_MAX_PACKETS    64
+/** Maximum length of a packet, in bytes */
+#define LOOPBACK_MAX_PACKET_LEN 64
+
+struct stLoopbackPacket {
+    /** When the packet may be received, in milliseconds */
+    uint32_t deliverAt;
+    uint16_t len;
+    uint8_t pData[LOOPBACK_MAX_PACKET_LEN];
+};
+typedef struct stLoopbackPacket loopbackPacket;
+
+struct stLoopbackCtx {
+    /** Ring of packets in flight on each channel */
+    loopbackPacket pPackets[LOOPBACK_CHANNELS][LOOPBACK_MAX_PACKETS];
+    /** Oldest packet on each channel */
+    int pHead[LOOPBACK_CHANNELS];
+    /** How many packets are in flight on each channel */
+    int pCount[LOOPBACK_CHANNELS];
+    /** Time since the transport was configured, in milliseconds */
+    uint32_t time;
+    /** State of the random generator, used to lose packets */
+    uint32_t seed;
+    /** Delay until a packet may be received, in milliseconds */
+    int latency;
+    /** Chance of losing a packet, in percent */
+    int loss;
+};
+typedef struct stLoopbackCtx loopbackCtx;
+
+/** The loopback transport. Declared on src/base/static.c. */
+extern SIM_LOCAL loopbackCtx loopback;
+
+/**
+ * Configure the transport, dropping any packet in flight.
+ *
+ * @param  [ in]latency Delay until a packet may be received, in milliseconds
+ * @param  [ in]loss    Chance of losing a packet, in percent
+ */
+void configureLoopback(int latency, int loss);
+
+/**
+ * Advance the transport's time.
+ *
+ * @param  [ in]elapsed Time since the last update, in milliseconds
+ */
+void updateLoopback(int elapsed);
+
+/**
+ * Send a packet. Just like a datagram, it's silently dropped if it's lost or if
+ * there are too many packets in flight.
+ *
+ * @param  [ in]channel The channel
+ * @param  [ in]pData   The packet
+ * @param  [ in]len     Length of the packet
+ */
+err loopbackSend(int channel, const void *pData, int len);
+
+/**
+ * Receive the oldest packet that already arrived.
+ *
+ * @param  [ in]channel The channel
+ * @param  [out]pData   The packet
+ * @param  [ in]maxLen  How many bytes fit on pData
+ * @return              Length of the packet, or 0 if none arrived
+ */
+int loopbackReceive(int channel, void *pData, int maxLen);
+
+#endif /* __BASE_LOOPBACK_H__ */
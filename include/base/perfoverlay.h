@@ -0,0 +1,69 @@
+/**
+ * @file include/base/perfoverlay.h
+ *
+ * In-game performance overlay. It shows a rolling graph of how long each frame
+ * took, the cost of the current update and draw against the frame's budget,
+ * how many collision pairs were handled, the depth of the resource loader's
+ * queue and a list of counters (e.g., entities) against their caps.
+ */
+#ifndef __BASE_PERFOVERLAY_H__
+#define __BASE_PERFOVERLAY_H__
+
+#include <base/error.h>
+
+/** Number of frames kept on the graph (one per column) */
+#define PERF_HISTORY        20
+/** Height of the graph, in lines */
+#define PERF_GRAPH_ROWS     6
+
+/** A value shown on the overlay against its maximum */
+struct stPerfCounter {
+    /** Label of the counter (at most 5 characters) */
+    char *pName;
+    /** Current value */
+    int value;
+    /** Maximum value */
+    int cap;
+};
+typedef struct stPerfCounter perfCounter;
+
+struct stPerfOverlayCtx {
+    /** Cost of the latest frames (update + draw), in microseconds. Used as a
+     * ring buffer */
+    int pFrameUs[PERF_HISTORY];
+    /** Position of the latest frame on pFrameUs */
+    int head;
+    /** Cost of the last update, in microseconds */
+    int updateUs;
+    /** Cost of the last draw, in microseconds */
+    int drawUs;
+    /** Number of collision pairs handled on the last update */
+    int collisionPairs;
+    /** Whether the overlay should be rendered */
+    int visible;
+};
+typedef struct stPerfOverlayCtx perfOverlayCtx;
+
+/** The performance overlay. Declared on src/base/static.c. */
+extern perfOverlayCtx perf;
+
+/** Show/hide the overlay */
+void togglePerfOverlay();
+
+/** Sample the update that just finished. Must be called after
+ * framePacerEndUpdate */
+void perfOverlayEndUpdate();
+
+/** Sample the draw that just finished. Must be called after
+ * framePacerEndDraw */
+void perfOverlayEndDraw();
+
+/**
+ * Render the overlay, if visible.
+ *
+ * @param  [ in]pList Game specific counters
+ * @param  [ in]len   Number of counters in pList
+ */
+void drawPerfOverlay(perfCounter *pList, int len);
+
+#endif /* __BASE_PERFOVERLAY_H__ */
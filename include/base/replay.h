@@ -0,0 +1,83 @@
+/**
+ * @file include/base/replay.h
+ *
+ * Record the input of every simulated frame (along with a hash of the
+ * simulation's state after that frame) and replay it later, reporting the
+ * first frame where the simulation diverged from the recording.
+ *
+ * Since the loadstate's duration depends on the resource loader (and not on
+ * the input), frames spent on it are neither recorded nor replayed.
+ */
+#ifndef __BASE_REPLAY_H__
+#define __BASE_REPLAY_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+enum enReplayMode {
+    RM_NONE = 0
+  , RM_RECORD
+  , RM_PLAY
+};
+typedef enum enReplayMode replayMode;
+
+struct stReplayCtx {
+    /** File being recorded into/replayed from (NULL if not active) */
+    FILE *pFile;
+    /** Number of frames recorded/replayed so far */
+    uint32_t frame;
+    /** First frame whose state didn't match the recording (-1 if none) */
+    int32_t divergedAt;
+    replayMode mode;
+    /** Whether the replay's result shouldn't be logged (e.g., because it's
+     * collected into the batch runner's report) */
+    int quiet;
+};
+typedef struct stReplayCtx replayCtx;
+
+/** The replay recorder/player. Declared on src/base/static.c. */
+extern SIM_LOCAL replayCtx replay;
+
+/**
+ * Start recording the input.
+ *
+ * @param  [ in]pPath Where the recording should be written
+ */
+err startRecording(char *pPath);
+
+/**
+ * Start replaying a previous recording. The game's input is ignored until it
+ * finishes.
+ *
+ * @param  [ in]pPath The recording
+ */
+err startReplay(char *pPath);
+
+/** Stop recording/replaying, reporting the replay's result (if any) */
+void stopReplay();
+
+/**
+ * Either record the current frame's input or overwrite it with the recorded
+ * one. Must be called after the input and the elapsed time are retrieved.
+ */
+err replayFrameInput();
+
+/**
+ * Either record the simulation's state hash or compare it against the
+ * recorded one. Must be called after the simulation is updated.
+ */
+err replayFrameState();
+
+/**
+ * Calculate a hash of every simulation-relevant state (i.e., anything that
+ * may change how the following frames play out).
+ *
+ * Different from the other functions on this module, this one is declared on
+ * src/jjat2/statehash.c, since it's specific to the game.
+ */
+uint32_t getSimulationHash();
+
+#endif /* __BASE_REPLAY_H__ */
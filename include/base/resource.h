@@ -13,27 +13,55 @@
 
 #include <base/error.h>
 
+/** Maximum number of resources that may be queued (or loading) at once */
+#define LOADER_MAX_JOBS     64
+/** How many resources may be loaded at once. GFraMe's async loader was written
+ * to back a single loading screen, and nothing guarantees that concurrent
+ * calls to gfm_loadAssetsAsync are safe, so resources are loaded one at a time,
+ * in the queue's order. */
+#define LOADER_MAX_IN_FLIGHT    1
+
+/** Priority of a resource on the loader's queue. Resources with a higher
+ * priority are loaded first. */
+enum enResourcePriority {
+    /** Songs, only decoded once requested. They never block the game (the song
+     * simply starts playing once ready) and the most recently requested one
+     * is loaded first, so the current level's song skips any stale request */
+    RES_PRIO_MUSIC = 0
+    /** Sound effects, required as soon as possible. These block the game (i.e.,
+     * isLoading() reports them) */
+  , RES_PRIO_SFX   = 1
+};
+typedef enum enResourcePriority resourcePriority;
+
+/** A resource that just finished loading, as appended to the completion list
+ * (see updateResourceLoader) */
+struct stResourceCompletion {
+    /** Index of the resource: the song's index (as in getSongHandle()) if
+     * isSong is set, or the sound effect's index otherwise */
+    int idx;
+    /** Handle of the loaded resource */
+    int handle;
+    /** Whether the resource is a song */
+    int isSong;
+};
+typedef struct stResourceCompletion resourceCompletion;
+
 /** Stores structures used when loading resources asynchronously */
 struct stLoaderCtx {
-    /** Temporary list of resource handles, passed to the loading thread */
-    int **ppHandles;
-    /** Temporary list of resources getting loaded. Declared as 'void*' to
-     * avoid including 'GFraMe/gfram.h' */
-    void *pResType;
-    /** Keeps both pointers to the loading files (at the start of the array)
-     * and the file names ('\0' ended) themself). */
-    char **pFiles;
-    /** Length, in elements, of ppHandles and pResType. Since pFiles store
-     * pointers to its files as well as as the strings themselves, it's actually
-     * much longer than len (it's at least "sizeof(char**)*len +
-     * sum(len(filename))" */
-    int len;
-    /* Length, in bytes, of pFiles */
-    int filesLen;
-    /** Progress status of the loader */
+    /** How many blocking resources were loaded since the loader was last idle
+     * (i.e., the progress shown on the loadstate) */
     int progress;
-    /** How many resources are currently being loaded */
+    /** How many blocking resources were queued since the loader was last
+     * idle. Both this and progress are reset once they match. */
     int numLoading;
+    /** How many resources are currently being loaded */
+    int numInFlight;
+    /** How many sound effects haven't finished loading */
+    int numSfx;
+    /** Sequence number of the next queued resource, so resources with the
+     * same priority are loaded in the order they were queued */
+    int seq;
 };
 typedef struct stLoaderCtx loaderCtx;
 
@@ -45,6 +73,9 @@ struct stResourceCtx {
     char *pNameBuf;
     /** Indexes to the starting position of songs in pNameBuf */
     int *pDynSong;
+    /** Hashed index (open addressing) of dynamically loaded songs, keyed by
+     * their names. Each slot stores the song's index, or -1 if empty */
+    int *pDynIndex;
     /** Everything required by the BG loader */
     loaderCtx loader;
     /* Number of handles currently stored in pHandles and pDynSong */
@@ -55,15 +86,27 @@ struct stResourceCtx {
     int nameBufLen;
     /* Number of bytes currently used in pNameBuf */
     int usedNameBuf;
+    /* Length, in elements, of pDynIndex (always a power of two) */
+    int dynIndexLen;
 };
 typedef struct stResourceCtx resourceCtx;
 
 /** Global resource context (declared on src/base/static.c) */
 extern resourceCtx res;
 
+/**
+ * Retrieve the next resource that finished loading, in the order they
+ * finished. Every completion is retrieved only once.
+ *
+ * @param  [out]pOut The completion
+ * @return           1 if a completion was retrieved, 0 if none is pending
+ */
+int popResourceCompletion(resourceCompletion *pOut);
+
 /**
  * Look through the pre-loaded list of songs and check if the desired song has
- * already been loaded. If not, ERR_LOADINGRESOURCE shall be returned. If it
+ * already been loaded. If not, ERR_LOADINGRESOURCE shall be returned and the
+ * song is queued to be decoded (ahead of any previously requested song). If it
  * does not exist in the pre-loaded list, ERR_INDEXOOB is returned instead.
  *
  * If either ERR_LOADINGRESOURCE or ERR_OK is returned, pIdx shall point to a
@@ -76,11 +119,10 @@ err fastGetSongIndex(int *pIdx, char *pName);
 
 /**
  * Check if a song has been dynamically loaded into the game and return the
- * index of its handle. If not found, but another resource is currently being
- * loaded, ERR_ALREADYLOADING shall be returned. If the songs has already been
- * added to the game but hasn't finished loading, ERR_LOADINGRESOURCE shall be
- * returned. If it does not exist in the pre-loaded list, ERR_INDEXOOB is
- * returned instead.
+ * index of its handle. If not found, it's queued to be loaded (ahead of any
+ * previously requested song) and ERR_LOADINGRESOURCE is returned. The same
+ * error is returned if the song was already queued but hasn't finished loading.
+ * If the loader's queue is full, ERR_ALREADYLOADING shall be returned.
  *
  * If either ERR_LOADINGRESOURCE or ERR_OK is returned, pIdx shall point to a
  * valid index, which may later be queried through getResourceHandle(idx).
@@ -91,11 +133,19 @@ err fastGetSongIndex(int *pIdx, char *pName);
 err getDynSongIndex(int *pIdx, char *pName);
 
 /**
- * Setup the resources with the hard-coded/pre-initialized songs and start
- * loading it.
+ * Setup the resources with the hard-coded/pre-initialized songs and queue
+ * every sound effect. Songs are only queued once requested.
  */
 err initResource();
 
+/**
+ * Collect every resource that finished loading (appending it to the completion
+ * list) and start loading the next ones on the queue. Must be called every
+ * frame. Loads are detected by polling GFraMe's progress counters, which its
+ * loading thread writes without any synchronization.
+ */
+err updateResourceLoader();
+
 /**
  * Release the context's resources.
  */
@@ -107,6 +157,12 @@ void cleanResource();
  */
 char *getCurrentResourceName();
 
+/**
+ * Get how many resources are waiting to be loaded (not counting the ones
+ * currently loading).
+ */
+int getLoaderQueueLength();
+
 /**
  * Check if anything is currently being loaded. Return 0 if false.
  */
@@ -42,6 +42,15 @@ int getSfxCount();
  */
 int getSoundCount();
 
+/**
+ * Start decoding a song that will soon be played (e.g., the next level's),
+ * without playing it. If the loader's queue is full, it's simply decoded once
+ * actually played.
+ *
+ * @param  [ in]pName The name of the song
+ */
+err prefetchSong(char *pName);
+
 /**
  * Check if a song is currently loaded and, if not, start loading it.
  *
@@ -50,7 +59,8 @@ int getSoundCount();
 err playSong(char *pName);
 
 /**
- * If any song was left pending, start playing it
+ * Drain every resource that finished loading and, if the pending song is among
+ * them, start playing it
  */
 err playPendingSong();
 
@@ -0,0 +1,52 @@
+/**
+ * @file include/base/simulation.h
+ *
+ * Everything that a single simulation reads and writes while it's updated is
+ * stored on thread-local storage. Therefore, each thread always works on its
+ * own independent simulation (its "current context"), and many simulations may
+ * run side by side, as long as each one has its own thread.
+ *
+ * A simulation is made of:
+ *   - game (base/game.h);
+ *   - input (base/input.h);
+ *   - collision (base/collision.h);
+ *   - playstate (jjat2/playstate.h);
+ *   - the hash of the last visible scene (src/jjat2/playstate.c);
+ *   - hitboxes (jjat2/hitbox.h);
+ *   - fx, and the effects' slots (jjat2/fx_group.h);
+ *   - teleport (jjat2/teleport.h);
+ *   - checkpoint (jjat2/checkpoint.h);
+ *   - lvltransition (jjat2/leveltransition.h);
+ *   - ui (jjat2/ui.h);
+ *   - signalBus (jjat2/events/signal.h);
+ *   - snapshots (jjat2/snapshot.h);
+ *   - the camera's tween (jjat2/camera.h);
+ *   - replay (base/replay.h), which drives the simulation's input;
+ *   - rewindBuffer (jjat2/rewind.h);
+ *   - netplay and its transport (jjat2/netplay.h and base/loopback.h);
+ *   - bot (jjat2/bot.h).
+ *
+ * Everything else is shared by the whole process, and must not be modified
+ * while more than a single simulation is running. That's the case for
+ * resources and spritesets (which are only read after being loaded), for the
+ * audio, and for the tools bound to the window (the trace, the frame pacer and
+ * the performance overlay). Simulations that run without a window (see
+ * base/batch.h) are flagged with CMD_HEADLESS and skip anything that would
+ * touch those.
+ *
+ * Note that the zeroize functions only clear the calling thread's simulation,
+ * so each thread must call them before setting up its simulation.
+ */
+#ifndef __BASE_SIMULATION_H__
+#define __BASE_SIMULATION_H__
+
+/** Storage class of every variable belonging to a simulation */
+#if defined(_MSC_VER)
+#  define SIM_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#  define SIM_LOCAL _Thread_local
+#else
+#  define SIM_LOCAL __thread
+#endif
+
+#endif /* __BASE_SIMULATION_H__ */
@@ -0,0 +1,88 @@
+/**
+ * @file include/base/trace.h
+ *
+ * Record scoped events (e.g., frames, level loads and asset loads) as Chrome's
+ * trace-event JSON, so they may be inspected on a timeline (chrome://tracing
+ * or Perfetto's UI).
+ *
+ * Every event is emitted once it finishes, as a "complete" event, so an error
+ * that interrupts a scope never leaves the trace unbalanced. While not
+ * recording, every call is a cheap no-op.
+ */
+#ifndef __BASE_TRACE_H__
+#define __BASE_TRACE_H__
+
+#include <base/error.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** File written when recording is started from the debug key */
+#define TRACE_DEFAULT_FILE  "trace.json"
+
+/** Track of events run on the main thread */
+#define TRACE_TID_MAIN      1
+/** Track of the asset loader */
+#define TRACE_TID_LOADER    2
+
+struct stTraceCtx {
+    /** File being recorded into (NULL when not recording) */
+    FILE *pFile;
+    /** Time when recording started, in microseconds. Every timestamp is
+     * relative to this */
+    uint64_t origin;
+    /** Number of events written so far */
+    int count;
+};
+typedef struct stTraceCtx traceCtx;
+
+/** The trace recorder. Declared on src/base/static.c. */
+extern traceCtx trace;
+
+/**
+ * Start recording events.
+ *
+ * @param  [ in]pPath Where the trace should be written
+ */
+err startTrace(char *pPath);
+
+/** Stop recording events and close the trace's file */
+void stopTrace();
+
+/** Start/stop recording into TRACE_DEFAULT_FILE */
+err toggleTrace();
+
+/**
+ * Retrieve the start of a scoped event. Returns 0 when not recording.
+ */
+uint64_t traceBegin();
+
+/**
+ * Finish a scoped event on the main thread's track. Nothing is recorded if
+ * start is 0 (i.e., recording wasn't active when the scope started).
+ *
+ * @param  [ in]start Value returned by traceBegin
+ * @param  [ in]pName Name of the event
+ */
+void traceEnd(uint64_t start, char *pName);
+
+/**
+ * Finish a scoped event and start the next one, to split a long scope into
+ * sequential steps.
+ *
+ * @param  [io]pStart Value returned by traceBegin (updated for the next step)
+ * @param  [ in]pName Name of the finished step
+ */
+void traceStep(uint64_t *pStart, char *pName);
+
+/**
+ * Record a scoped event on any track (e.g., one that run on another thread).
+ *
+ * @param  [ in]pName Name of the event
+ * @param  [ in]tid   The event's track
+ * @param  [ in]start Value returned by traceBegin
+ * @param  [ in]end   When the event finished, in microseconds
+ */
+void traceEvent(char *pName, int tid, uint64_t start, uint64_t end);
+
+#endif /* __BASE_TRACE_H__ */
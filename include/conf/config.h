@@ -26,7 +26,24 @@ struct stConfigCtx {
 #if defined(JJATENGINE)
     /** Alternative key mapping */
     char *pKeyMap;
+    /** Latency of the netplay's loopback transport, in milliseconds (-1 if
+     * netplay is disabled) */
+    int netplayLatency;
+    /** Chance of losing a packet on the loopback transport, in percent */
+    int netplayLoss;
+    /** List of jobs run by the batch runner (if any) */
+    char *pBatchFile;
+    /** Number of threads used by the batch runner (0 uses one for each core) */
+    int batchWorkers;
+    /** Level played by the bot's CLI (if any) */
+    char *pBotLevel;
 #endif /* JJATENGINE */
+    /** File where a trace should be recorded (if any) */
+    char *pTraceFile;
+    /** File where the input should be recorded (if any) */
+    char *pRecordFile;
+    /** Recording that should be replayed (if any) */
+    char *pReplayFile;
     /** Bit-mask for flags */
     configFlags flags;
     /** Initial window width */
@@ -35,6 +52,8 @@ struct stConfigCtx {
     int wndHeight;
     /** Initial FPS (base FPS and update/draw rate) */
     int fpsQuality;
+    /** Maximum number of draws skipped in a row, to keep the update rate */
+    int maxFrameskip;
     /** Index of fullscreen resolution (if on fullscreen mode) */
     int fullscreenResolution;
     /** Video backend */
@@ -48,11 +67,20 @@ typedef struct stConfigCtx configCtx;
 #define CONFIG_INIT(c) \
   do { \
     (c).pKeyMap = 0; \
+    (c).netplayLatency = -1; \
+    (c).netplayLoss = 0; \
+    (c).pBatchFile = 0; \
+    (c).batchWorkers = 0; \
+    (c).pBotLevel = 0; \
+    (c).pTraceFile = 0; \
+    (c).pRecordFile = 0; \
+    (c).pReplayFile = 0; \
     (c).flags = 0;\
     (c).fullscreenResolution = 0; \
     (c).wndWidth = 640;\
     (c).wndHeight = 480;\
     (c).fpsQuality = 60;\
+    (c).maxFrameskip = 4;\
     (c).videoBackend = GFM_VIDEO_SDL2;\
     (c).audioSettings = gfmAudio_defQuality;\
   } while (0)
@@ -31,6 +31,9 @@
     X(ERR_ALREADYLOADING) \
     X(ERR_LOADINGRESOURCE) \
     X(ERR_OOM) \
+    X(ERR_OPENFILE) \
+    X(ERR_BATCHFAILED) \
+    X(ERR_SNAPSHOTMISMATCH) \
     X(ERR_MAX)
 
 #endif /* __CONF_ERROR_LIST_H__ */
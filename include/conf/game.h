@@ -18,8 +18,8 @@
 #define TITLE       "JJAT+"
 /** Initial background color (only for the virtual window) */
 #define BG_COLOR    0xFF222034
-/** Name of the first map loaded */
-#define FIRST_MAP   "lab/awakening_passage"
+/** The first map loaded (see conf/level_list.h) */
+#define FIRST_MAP   LVL_LAB_AWAKENING_PASSAGE
 
 #endif /* __CONF_GAME_H__ */
 
@@ -106,12 +106,22 @@
         , gfmKey_f11) \
      X_KEY(gif \
         , gfmKey_f10) \
+     X_KEY(dbgTrace \
+        , gfmKey_f9) \
+     X_KEY(dbgPerf \
+        , gfmKey_f8) \
      X_KEY(dbgResetFps \
         , gfmKey_f7) \
      X_KEY(dbgStep \
         , gfmKey_f6) \
      X_KEY(dbgPause \
         , gfmKey_f5) \
+     X_KEY(dbgLoadState \
+        , gfmKey_f4) \
+     X_KEY(dbgSaveState \
+        , gfmKey_f3) \
+     X_KEY(dbgRewind \
+        , gfmKey_f2) \
      X_KEY(dbgSetPos \
         , gfmPointer_button)
 #else
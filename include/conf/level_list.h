@@ -0,0 +1,62 @@
+/**
+ * @file include/conf/level_list.h
+ *
+ * Manifest of every level in the world (i.e., everything within
+ * assets/levels/). Levels are referred to by their position on this list, so
+ * a level's name is only looked up while parsing a map or a command line.
+ */
+#ifndef __CONF_LEVEL_LIST_H__
+#define __CONF_LEVEL_LIST_H__
+
+/**
+ * List of levels. Tuple with (id, name, song), where name is the level's path
+ * within "levels/", without any suffix, and song is the song its objects play
+ * (empty if it keeps the current one). The song only gets decoded ahead of
+ * time, during the transition into the level, so it must match the level's
+ * "play" resource.
+ */
+#define LEVELS_LIST \
+  X(LVL_AWAKENING_PASSAGE, "awakening_passage", "") \
+  X(LVL_BEWARE_THE_SPIKES, "beware_the_spikes", "") \
+  X(LVL_BLINK_WISELY, "blink_wisely", "") \
+  X(LVL_CARRIED_AWAY, "carried_away", "") \
+  X(LVL_CARRY_IT, "carry_it", "") \
+  X(LVL_DANGER_EVERYWHERE, "danger_everywhere", "") \
+  X(LVL_GAME_START, "game_start", "") \
+  X(LVL_GETTING_TRICKY, "getting_tricky", "") \
+  X(LVL_HARMFUL_SPIKES, "harmful_spikes", "") \
+  X(LVL_HARMLESS_BADDIES, "harmless_baddies", "") \
+  X(LVL_HERE_AND_THERE, "here_and_there", "") \
+  X(LVL_LAB_ALMOST_TOGETHER, "lab/almost_together", "") \
+  X(LVL_LAB_AWAKENING_PASSAGE, "lab/awakening_passage", "intro.mml") \
+  X(LVL_LAB_BEWARE_THE_SPIKES, "lab/beware_the_spikes", "") \
+  X(LVL_LAB_BIG_FLUFFY_FOE, "lab/big_fluffy_foe", "") \
+  X(LVL_LAB_BLINK_WISELY, "lab/blink_wisely", "") \
+  X(LVL_LAB_CARRIED_AWAY, "lab/carried_away", "") \
+  X(LVL_LAB_CARRY_IT, "lab/carry_it", "") \
+  X(LVL_LAB_CHECKUP_TEST, "lab/checkup_test", "first-steps.mml") \
+  X(LVL_LAB_DANGER_EVERYWHERE, "lab/danger_everywhere", "") \
+  X(LVL_LAB_FREE_IT, "lab/free_it", "") \
+  X(LVL_LAB_HARMFUL_SPIKES, "lab/harmful_spikes", "") \
+  X(LVL_LAB_HARMLESS_CRITTERS, "lab/harmless_critters", "") \
+  X(LVL_LAB_HERE_AND_THERE, "lab/here_and_there", "") \
+  X(LVL_LAB_HURDLES, "lab/hurdles", "") \
+  X(LVL_LAB_IS_THAT_A_HAT, "lab/is_that_a_hat", "") \
+  X(LVL_LAB_MECH_REPRISE, "lab/mech_reprise", "") \
+  X(LVL_LAB_OLD_TRICK, "lab/old_trick", "") \
+  X(LVL_LAB_POSITIONING_TEST, "lab/positioning_test", "") \
+  X(LVL_LAB_REMOTE_ASSISTANCE, "lab/remote_assistance", "") \
+  X(LVL_LAB_RUN_TOGETHER, "lab/run_together", "") \
+  X(LVL_LAB_SOMETHING_IS_COMING, "lab/something_is_coming", "") \
+  X(LVL_LAB_SPIKES_WARNING, "lab/spikes_warning", "") \
+  X(LVL_LAB_SPOTTED, "lab/spotted", "") \
+  X(LVL_LAB_SYMBIOTIC_FORMS, "lab/symbiotic_forms", "") \
+  X(LVL_LAB_TAKE_IT_EASY, "lab/take_it_easy", "") \
+  X(LVL_LAB_THE_MEETING, "lab/the_meeting", "starting-to-move.mml") \
+  X(LVL_LAB_TWO_WAYS, "lab/two_ways", "") \
+  X(LVL_NOT_SO_HARMLESS, "not_so_harmless", "") \
+  X(LVL_RIDE_IT_AWAY, "ride_it_away", "") \
+  X(LVL_SHORT_BREATHER, "short_breather", "") \
+  X(LVL_THE_MEETING, "the_meeting", "")
+
+#endif /* __CONF_LEVEL_LIST_H__ */
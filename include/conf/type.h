@@ -47,7 +47,6 @@ enum enType {
     , T_EN_WALKY        = (1 << T_BASE_NBITS) | T_ENEMY
     , T_EN_G_WALKY      = (2 << T_BASE_NBITS) | T_ENEMY
     , T_EN_G_WALKY_ATK  = (3 << T_BASE_NBITS) | T_ENEMY
-    , T_EN_G_WALKY_VIEW = (4 << T_BASE_NBITS) | T_ENEMY
     , T_EN_SPIKY        = (5 << T_BASE_NBITS) | T_ENEMY
     , T_EN_TURRET       = (6 << T_BASE_NBITS) | T_ENEMY
     , T_SWORD_FX        = (1 << T_BASE_NBITS) | T_FX
@@ -0,0 +1,131 @@
+/**
+ * @file include/jjat2/bot.h
+ *
+ * Step the simulation one frame at a time from a bot's buttons (instead of the
+ * player's input), retrieving a compact observation after every frame. Nothing
+ * is ever drawn, so a simulation may be stepped as fast as it can be updated.
+ *
+ * Just like the batch runner, the bot runs on the calling thread's simulation
+ * (see base/simulation.h), so many bots may run in parallel (one for each
+ * thread). The thread's GFraMe context must be set on game before initBot is
+ * called (one without a window is enough).
+ *
+ * A thin CLI, runBotCli, reads commands from the standard input:
+ *   - "<buttons> [count]": step count frames (1, by default) with the buttons
+ *     (a bit-mask of botButton, in hexadecimal) and print the observation;
+ *   - "view": print the type of every tile around each player;
+ *   - "reset [level]": reload the level (or load another one);
+ *   - "quit": exit.
+ */
+#ifndef __JJAT2_BOT_H__
+#define __JJAT2_BOT_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <jjat2/playstate.h>
+
+#include <stdint.h>
+
+/** Width of the area observed around each player, in tiles */
+#define BOT_VIEW_WIDTH  9
+/** Height of the area observed around each player, in tiles */
+#define BOT_VIEW_HEIGHT 7
+
+/** Buttons of each character. Gunny's are shifted by BOT_GUNNY_SHIFT. */
+enum enBotButton {
+    BOT_LEFT  = 0x01
+  , BOT_RIGHT = 0x02
+  , BOT_JUMP  = 0x04
+  , BOT_ATK   = 0x08
+};
+typedef enum enBotButton botButton;
+
+/** How many bits gunny's buttons are shifted within the bit-mask */
+#define BOT_GUNNY_SHIFT 4
+
+enum enBotStatus {
+    /** Swordy survived the latest frame */
+    BOT_SWORDY_ALIVE = 0x01
+    /** Gunny survived the latest frame */
+  , BOT_GUNNY_ALIVE  = 0x02
+    /** Both players entered a loadzone on the latest frame */
+  , BOT_LOADZONE     = 0x04
+    /** A level transition (either to another level or to the checkpoint) is
+     * playing, so the players can't be controlled */
+  , BOT_TRANSITION   = 0x08
+};
+typedef enum enBotStatus botStatus;
+
+/** What the bot sees of a single player */
+struct stBotPlayer {
+    /** Player's position, in pixels */
+    int16_t x;
+    int16_t y;
+    /** Type of each tile around the player (0 if none), centered on it */
+    uint16_t pTiles[BOT_VIEW_HEIGHT][BOT_VIEW_WIDTH];
+};
+typedef struct stBotPlayer botPlayer;
+
+struct stBotObservation {
+    botPlayer swordy;
+    botPlayer gunny;
+    /** Frames simulated since the level was loaded */
+    uint32_t frame;
+    /** Bit-mask of botStatus */
+    uint8_t status;
+};
+typedef struct stBotObservation botObservation;
+
+struct stBotCtx {
+    /** Level loaded by the latest reset */
+    levelId level;
+    /** Frames simulated since the level was loaded */
+    uint32_t frame;
+    /** Buttons pressed on the previous frame */
+    uint8_t buttons;
+    /** Whether the simulation was initialized */
+    uint8_t isInit;
+};
+typedef struct stBotCtx botCtx;
+
+/** The current thread's bot. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL botCtx bot;
+
+/** Initialize the simulation so it may be stepped by the bot */
+err initBot();
+
+/** Release the bot's simulation */
+void freeBot();
+
+/**
+ * Load a level, placing the players on its starting position.
+ *
+ * @param  [ in]pLevel The level
+ */
+err resetBot(char *pLevel);
+
+/**
+ * Retrieve the observation of the current frame.
+ *
+ * @param  [out]pObs The observation
+ */
+void observeBot(botObservation *pObs);
+
+/**
+ * Simulate a single frame.
+ *
+ * @param  [out]pObs    The observation after the frame (may be NULL)
+ * @param  [ in]buttons Bit-mask of the pressed buttons (botButton for swordy,
+ *                      and botButton << BOT_GUNNY_SHIFT for gunny)
+ */
+err stepBot(botObservation *pObs, uint8_t buttons);
+
+/**
+ * Run the bot from commands read from the standard input.
+ *
+ * @param  [ in]pLevel The first level
+ */
+err runBotCli(char *pLevel);
+
+#endif /* __JJAT2_BOT_H__ */
@@ -9,6 +9,8 @@
 #include <base/error.h>
 #include <jjat2/entity.h>
 
+#include <stdint.h>
+
 /**
  * Center the camera at both characters.
  *
@@ -27,5 +29,24 @@ err resetCameraPosition(entityCtx *pSwordy, entityCtx *pGunny);
  */
 err updateCamera(entityCtx *pSwordy, entityCtx *pGunny);
 
+/**
+ * Accumulate the camera's state (position and tween) into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashCamera(uint32_t hash);
+
+/** Retrieve the current tween factor between both characters */
+int getCameraTween();
+
+/**
+ * Overwrite the tween factor between both characters (e.g., when restoring a
+ * snapshot)
+ *
+ * @param  [ in]tween The tween factor
+ */
+void setCameraTween(int tween);
+
 #endif /* __JJAT2_CAMERA_H__ */
 
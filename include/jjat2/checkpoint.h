@@ -5,6 +5,7 @@
 #define __JJAT2_CHECKPOINT_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 #include <conf/type.h>
 #include <jjat2/leveltransition.h>
 #include <jjat2/playstate.h>
@@ -14,7 +15,7 @@ struct stCheckpointCtx {
 };
 typedef struct stCheckpointCtx checkpointCtx;
 
-extern checkpointCtx checkpoint;
+extern SIM_LOCAL checkpointCtx checkpoint;
 
 /**
  * Assign a new checkpoint, overwritting the previous one
@@ -7,6 +7,9 @@
 #define __JJAT2_ENTITY_H__
 
 #include <base/error.h>
+#if defined(JJAT_FIXED_PHYSICS)
+#  include <base/fixed.h>
+#endif /* JJAT_FIXED_PHYSICS */
 
 #include <GFraMe/gfmHitbox.h>
 #include <GFraMe/gfmSprite.h>
@@ -73,10 +76,19 @@ struct stEntityCtx {
     gfmSprite *pSelf;
     /** Sprite (if any) that is carrying this entity */
     struct stEntityCtx *pCarrying;
-    /** Entity's sight, if any */
-    gfmHitbox *pSight;
     /** Generic entity flags */
     entityFlag flags;
+    /** Node of the entity on the current frame's carry graph (only valid while
+     * that node points back to the entity; see src/jjat2/entity.c) */
+    uint8_t carryNode;
+    /** Latest floor span (see jjat2/floorspan.h) the entity walked on, kept as
+     * a cache (-1 if none) */
+    int32_t floorSpan;
+#if defined(JJAT_FIXED_PHYSICS)
+    /** Position, with sub-pixel precision */
+    fixed fx;
+    fixed fy;
+#endif /* JJAT_FIXED_PHYSICS */
     /** Time, in milliseconds, while jump may be pressed after leaving the
      * ground */
     int16_t jumpGrace;
@@ -104,6 +116,22 @@ struct stEntityCtx {
 };
 typedef struct stEntityCtx entityCtx;
 
+/** The physical state of a sprite and its displayed frame, so it may be later
+ * restored. The animation itself is played again by its owner (i.e., the
+ * entity or the effect), since GFraMe can't seek within an animation */
+struct stSpriteState {
+    double vx;
+    double vy;
+    double ax;
+    double ay;
+    int x;
+    int y;
+    int dir;
+    /** Frame currently displayed */
+    int frame;
+};
+typedef struct stSpriteState spriteState;
+
 /** NOTE: There's no freeEntity because it's usually static */
 
 /**
@@ -172,13 +200,27 @@ err preUpdateEntity(entityCtx *entity);
 /**
  * Post update an entity
  *
- * During this stage, the entity fixes its collision against the world and any
- * carrying sprite.
+ * The entity's position was already fixed against its carrier (if any) by
+ * resolveCarryGraph, so this is only kept as the common post-update step.
  *
  * @param  [ in]entity   The entity
  */
 err postUpdateEntity(entityCtx *entity);
 
+/** Start a new carry graph. Must be called before colliding any entity. */
+void clearCarryGraph();
+
+/**
+ * Fix the position of every entity being carried, from the bottom of each stack
+ * to its top, so horizontal movement is correctly propagated through the
+ * stack. Cycles (e.g., two entities landing on each other on the same frame)
+ * are broken by ignoring one of the links.
+ *
+ * Must be called after every entity was collided (and before post-updating
+ * them).
+ */
+err resolveCarryGraph();
+
 /**
  * Draw the entity
  *
@@ -205,7 +247,7 @@ void setEntityDirection(entityCtx *entity);
  * Simple collision check between two entities
  *
  * If this function detects collision, it ensures one entity will be carried by
- * the other, and only that.
+ * the other, and only that. The carried entity is added to the carry graph.
  *
  * @param  [ in]entA One of the entities
  * @param  [ in]entB The other entity
@@ -235,5 +277,32 @@ void killEntity(entityCtx *entity);
  */
 void flipEntityOnEdge(entityCtx *entity, double vx);
 
+/**
+ * Retrieve a sprite's state (position, velocity, acceleration, direction and
+ * frame)
+ *
+ * @param  [out]pState The sprite's state
+ * @param  [ in]pSpr   The sprite
+ */
+void getSpriteState(spriteState *pState, gfmSprite *pSpr);
+
+/**
+ * Restore a sprite's state. Its animation must already be playing (see
+ * setEntityAnimation), as this only displays the stored frame over it.
+ *
+ * @param  [ in]pSpr   The sprite
+ * @param  [ in]pState The sprite's state
+ */
+err setSpriteState(gfmSprite *pSpr, spriteState *pState);
+
+/**
+ * Accumulate a sprite's displayed frame into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @param  [ in]pSpr The sprite
+ * @return           The updated hash
+ */
+uint32_t hashSpriteAnimation(uint32_t hash, gfmSprite *pSpr);
+
 #endif /* __JJAT2_ENTITY_H__ */
 
@@ -11,14 +11,6 @@
 #include <GFraMe/gfmParser.h>
 #include <jjat2/entity.h>
 
-/**
- * Clear the local variables common to all events.
- *
- * These variables are "local" because they should get cleared on screen
- * transition.
- */
-void clearLocalVariables();
-
 /**
  * Parse an event into the entity
  *
@@ -44,6 +36,13 @@ err preUpdateEvent(entityCtx *pEnt);
  */
 err postUpdateEvent(entityCtx *pEnt);
 
+/**
+ * Notify an event that any of the signals it subscribed to changed
+ *
+ * @param  [ in]pEnt    The entity
+ */
+err notifyEvent(entityCtx *pEnt);
+
 /**
  * Draw an event
  *
@@ -25,7 +25,14 @@ err initDoor(entityCtx *pEnt, gfmParser *pParser, int isVertical);
 err preUpdateDoor(entityCtx *pEnt);
 
 /**
- * Change the door's animation depending on the local variables
+ * Mark the door to be updated, as its signals changed
+ *
+ * @param  [ in]pEnt    The entity
+ */
+void onDoorSignal(entityCtx *pEnt);
+
+/**
+ * Change the door's animation depending on its signals
  *
  * @param  [ in]pEnt    The entity
  */
@@ -31,11 +31,11 @@ err postUpdatePressurePad(entityCtx *pEnt);
 err drawPressurePad(entityCtx *pEnt);
 
 /**
- * Activate the pressure pad (and set any local var if fully pressed)
+ * Activate the pressure pad (and raise its signals if fully pressed)
  *
  * @param  [ in]pEnt    The entity
  */
-void pressPressurePad(entityCtx *pEnt);
+err pressPressurePad(entityCtx *pEnt);
 
 #endif /* __EVENTS_PRESSURE_PAD_H__ */
 
@@ -0,0 +1,102 @@
+/**
+ * @file include/jjat2/events/signal.h
+ *
+ * Named signals that events publish and listen to (e.g., pressure pads raise
+ * the signals that unlock doors).
+ *
+ * Signals are scoped to the level: their names are taken from the events'
+ * properties (e.g., "set_0 = A" or "lock_0 = A") and registered while the
+ * level is parsed. Each signal counts how many emitters are currently raising
+ * it, and its subscribers are only notified when it changes between lowered and
+ * raised. Therefore, nothing has to be cleared nor polled every frame.
+ */
+#ifndef __EVENTS_SIGNAL_H__
+#define __EVENTS_SIGNAL_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <jjat2/entity.h>
+
+#include <stdint.h>
+
+/** Maximum number of signals on a single level */
+#define MAX_SIGNALS     16
+/** Maximum length of a signal's name (including the '\0') */
+#define MAX_SIGNAL_NAME 16
+
+enum enSignalBits {
+    /** Events store the signals they use on the lower bits of their flags */
+    EV_SIGNAL_MASK  = 0x0000FFFF
+    /** First bit available for the event itself */
+  , EV_SIGNAL_SHIFT = 16
+};
+
+/** Everything about the signals that changes while a level is played */
+struct stSignalState {
+    /** Number of emitters currently raising each signal */
+    uint8_t pEmitters[MAX_SIGNALS];
+    /** Bitmask of the signals currently raised */
+    uint32_t raised;
+};
+typedef struct stSignalState signalState;
+
+struct stSignalBusCtx {
+    signalState state;
+    /** Entities notified whenever a signal changes, as a bitmask of their
+     * indices on playstate.entities */
+    uint32_t pSubscribers[MAX_SIGNALS];
+    /** Name of each signal */
+    char pNames[MAX_SIGNALS][MAX_SIGNAL_NAME];
+    /** Number of signals on the current level */
+    int count;
+};
+typedef struct stSignalBusCtx signalBusCtx;
+
+/** The signals of the current level. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL signalBusCtx signalBus;
+
+/** Remove every signal (and subscriber), before loading a level */
+void resetSignals();
+
+/**
+ * Retrieve a signal by its name, registering it if not used yet.
+ *
+ * @param  [out]pMask  Bitmask with only the signal set
+ * @param  [ in]pName  The signal's name
+ */
+err getSignal(uint32_t *pMask, char *pName);
+
+/**
+ * Notify an event whenever any of the signals changes.
+ *
+ * @param  [ in]pEnt The event (must be on playstate.entities)
+ * @param  [ in]mask Bitmask of signals
+ */
+err subscribeSignals(entityCtx *pEnt, uint32_t mask);
+
+/**
+ * Start emitting signals (notifying the subscribers of those that were
+ * lowered).
+ *
+ * @param  [ in]mask Bitmask of signals
+ */
+err raiseSignals(uint32_t mask);
+
+/**
+ * Stop emitting signals (notifying the subscribers of those that are no longer
+ * emitted by anyone).
+ *
+ * @param  [ in]mask Bitmask of signals
+ */
+err lowerSignals(uint32_t mask);
+
+/**
+ * Check whether every signal is currently raised.
+ *
+ * @param  [ in]mask Bitmask of signals
+ * @return           1 if all of them are raised, 0 otherwise
+ */
+int areSignalsRaised(uint32_t mask);
+
+#endif /* __EVENTS_SIGNAL_H__ */
@@ -0,0 +1,82 @@
+/**
+ * @file include/jjat2/floorspan.h
+ *
+ * Horizontal runs of tiles (i.e., the platforms entities may walk on) found
+ * when a level is loaded.
+ *
+ * Every row of the tilemap is split into spans: the longest sequences of tiles
+ * with a type (any type). An entity walking on a span reaches an edge as soon
+ * as it would step beyond one of the span's ends, so patrolling entities may
+ * simply compare their position against the span's bounds (instead of looking
+ * up the tilemap every frame).
+ *
+ * Spans are stored sorted by row and then by column, and each row keeps the
+ * index of its first span. Since entities walk on the same span for many
+ * frames, they usually keep their latest span as a cache.
+ */
+#ifndef __JJAT2_FLOORSPAN_H__
+#define __JJAT2_FLOORSPAN_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <stdint.h>
+
+/** A single platform */
+struct stFloorSpan {
+    /** Row of the span, in tiles */
+    uint16_t row;
+    /** First tile of the span (inclusive) */
+    uint16_t left;
+    /** Last tile of the span (inclusive) */
+    uint16_t right;
+};
+typedef struct stFloorSpan floorSpan;
+
+struct stFloorSpansCtx {
+    /** Every span, sorted by row and then by column */
+    floorSpan *pSpans;
+    /** Index of the first span of each row. There's an extra entry at the end,
+     * so the spans of row i are within [pRows[i], pRows[i + 1]) */
+    uint16_t *pRows;
+    /** Capacity of pSpans, in spans */
+    int spansLen;
+    /** Capacity of pRows, in rows */
+    int rowsLen;
+    /** Number of spans on the current level */
+    int count;
+    /** Dimensions of the current level, in tiles */
+    int width;
+    int height;
+};
+typedef struct stFloorSpansCtx floorSpansCtx;
+
+/** The spans of the current level. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL floorSpansCtx floorSpans;
+
+/** Find every span on the currently loaded tilemap (playstate.pMap) */
+err buildFloorSpans();
+
+/** Release the spans */
+void freeFloorSpans();
+
+/**
+ * Retrieve the span that contains a tile.
+ *
+ * @param  [ in]tileX The tile's position, in tiles
+ * @param  [ in]tileY The tile's position, in tiles
+ * @return            The span's index, or -1 if the tile isn't on any span
+ */
+int getFloorSpan(int tileX, int tileY);
+
+/**
+ * Check whether there's a span on a tile, using (and updating) a cached span.
+ *
+ * @param  [ io]pCache The latest span found by the caller (-1 if none)
+ * @param  [ in]tileX  The tile's position, in tiles
+ * @param  [ in]tileY  The tile's position, in tiles
+ * @return             1 if the tile is on a span, 0 otherwise
+ */
+int isOnFloorSpan(int32_t *pCache, int tileX, int tileY);
+
+#endif /* __JJAT2_FLOORSPAN_H__ */
@@ -9,12 +9,17 @@
 #define __JJAT2_FX_GROUP_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 
 #include <conf/type.h>
 
 #include <GFraMe/gfmGroup.h>
 #include <GFraMe/gfmSprite.h>
 
+#include <jjat2/entity.h>
+
+#include <stdint.h>
+
 /** Maximum number of concurrent effects on screen */
 #define MAX_FX_NUM  128
 
@@ -34,8 +39,23 @@ enum enFxAnim {
 };
 typedef enum enFxAnim fxAnim;
 
+/** A live effect's state, so it may be later respawned */
+struct stFxState {
+    spriteState spr;
+    /** Remaining time to live (0 if spawned without a TTL) */
+    int ttl;
+    int offx;
+    int offy;
+    int16_t w;
+    int16_t h;
+    int16_t t;
+    uint8_t anim;
+    uint8_t flipped;
+};
+typedef struct stFxState fxState;
+
 /** The group of effects/hitboxes */
-extern gfmGroup *fx;
+extern SIM_LOCAL gfmGroup *fx;
 
 /**
  * Spawn a new effect at the desired position
@@ -62,5 +82,55 @@ void freeFxGroup();
 /** Update and collide the effects */
 err updateFxGroup();
 
+/** Remove every effect from the group */
+err killAllFx();
+
+/**
+ * Remove an effect before it dies by itself
+ *
+ * @param  [ in]pNode The effect's node
+ */
+err removeFx(gfmGroupNode *pNode);
+
+/**
+ * Check whether any effect may still be alive (and, therefore, animating).
+ *
+ * @return 1 if idle, 0 otherwise
+ */
+int isFxGroupIdle();
+
+/**
+ * Count how many effects are alive. Just like isFxGroupIdle, effects without a
+ * TTL are counted until explicitly removed.
+ */
+int getFxCount();
+
+/**
+ * Accumulate the state of every live effect into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashFx(uint32_t hash);
+
+/**
+ * Store the state of every live effect.
+ *
+ * @param  [out]pList  The effects' states
+ * @param  [ in]maxLen How many states fit on the list
+ * @param  [ in]pSkip  An effect that shouldn't be stored (may be NULL)
+ * @return             How many effects were stored
+ */
+int saveFx(fxState *pList, int maxLen, gfmGroupNode *pSkip);
+
+/**
+ * Replace every effect with the previously stored ones. Animations are played
+ * again from their start, displaying the stored frame.
+ *
+ * @param  [ in]pList The effects' states
+ * @param  [ in]len   How many states there are on the list
+ */
+err restoreFx(fxState *pList, int len);
+
 #endif /* __JJAT2_FX_GROUP_H__ */
 
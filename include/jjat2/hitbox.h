@@ -8,14 +8,33 @@
 #define __JJAT2_HITBOX_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 #include <GFraMe/gfmHitbox.h>
 #include <stdint.h>
 
 #define MAX_HITBOXES    32
 
+/** How a hitbox was spawned, so it may be later spawned again exactly */
+struct stHitboxState {
+    /** Context associated with the hitbox */
+    void *pCtx;
+    /** The spawned hitbox, so its state may be found from it */
+    gfmHitbox *pHitbox;
+    int x;
+    int y;
+    int width;
+    int height;
+    int type;
+    /** Sides that collide, as set by setHitboxFlag (-1 if never set) */
+    int hitFlag;
+};
+typedef struct stHitboxState hitboxState;
+
 struct stHitboxesCtx {
     /** The list of hitboxes */
     gfmHitbox *pList;
+    /** How each hitbox on the list was spawned */
+    hitboxState states[MAX_HITBOXES];
     /** How many fixed hitboxes there are, from the start of the list */
     uint8_t used;
     /** Transient hitboxes count, starting at the end of the list */
@@ -23,7 +42,7 @@ struct stHitboxesCtx {
 };
 typedef struct stHitboxesCtx hitboxesCtx;
 
-extern hitboxesCtx hitboxes;
+extern SIM_LOCAL hitboxesCtx hitboxes;
 
 /** Initialize the context */
 err initHitboxes();
@@ -64,6 +83,32 @@ gfmHitbox* spawnFixedHitbox(void *pCtx, int x, int y, int width, int height, int
  */
 gfmHitbox* spawnTmpHitbox(void *pCtx, int x, int y, int width, int height, int type);
 
+/**
+ * Set which sides of a spawned hitbox collide.
+ *
+ * @param  [ in]pHitbox The hitbox
+ * @param  [ in]flag    The sides (a gfmCollision bitmask)
+ */
+void setHitboxFlag(gfmHitbox *pHitbox, int flag);
+
+/**
+ * Replace every hitbox with the previously stored ones (i.e., a copy of
+ * hitboxes.states and of its counters).
+ *
+ * @param  [ in]pList   How every hitbox was spawned
+ * @param  [ in]used    How many fixed hitboxes there are
+ * @param  [ in]tmpUsed How many transient hitboxes there are
+ */
+err restoreHitboxes(hitboxState *pList, int used, int tmpUsed);
+
+/**
+ * Accumulate every live hitbox into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashHitboxes(uint32_t hash);
+
 /** Collide every hitbox */
 err collideHitbox();
 
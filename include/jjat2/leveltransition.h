@@ -8,10 +8,13 @@
 #define __JJAT2_LEVELTRANSITION_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 
 #include <GFraMe/gfmHitbox.h>
 #include <GFraMe/gfmTilemap.h>
 
+#include <jjat2/world.h>
+
 #include <stdint.h>
 
 #define MAX_AREAS   16
@@ -32,7 +35,7 @@ enum {
 
 struct stLeveltransitionData {
     /** Level that will be transitioned to */
-    char *pName;
+    levelId level;
     /** Source position within the teleported level (and clamped to the edge of
      * the screen) */
     uint16_t srcX;
@@ -78,7 +81,7 @@ struct stLeveltransitionCtx {
 typedef struct stLeveltransitionCtx leveltransitionCtx;
 
 /** Animation for the level transition */
-extern leveltransitionCtx lvltransition;
+extern SIM_LOCAL leveltransitionCtx lvltransition;
 
 /**
  * Prepare switching to a level transition
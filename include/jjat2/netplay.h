@@ -0,0 +1,137 @@
+/**
+ * @file include/jjat2/netplay.h
+ *
+ * Rollback netplay between two peers, each controlling a single character.
+ *
+ * Every frame, the local input is sent to the remote peer, and the remote
+ * player's input is predicted (by repeating the latest one received). Once the
+ * remote input for a frame arrives and it differs from what was predicted, the
+ * playstate is restored from the snapshot taken before that frame and every
+ * frame since is simulated again.
+ *
+ * For now, the only transport is the loopback stand-in. The remote peer is
+ * emulated by sending gunny's buttons (read from this machine) through it, so
+ * rollback may be tested with a single computer. The emulated peer also keeps
+ * its own copy of the playstate (as a snapshot), which only simulates frames
+ * once it received their input, so it never has to roll back.
+ *
+ * Every packet also carries the hash (getSimulationHash()) of the latest frame
+ * simulated by the peer that sent it. Once that frame can't be rolled back
+ * anymore, it's compared against the local hash for the same frame, so any
+ * divergence between the peers gets detected.
+ *
+ * Rolling back is only possible within the playstate. Any frame that triggered
+ * a level transition (or a respawn) is final, and the emulated peer restarts
+ * from the local playstate once the next level is loaded.
+ */
+#ifndef __JJAT2_NETPLAY_H__
+#define __JJAT2_NETPLAY_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <jjat2/snapshot.h>
+
+#include <stdint.h>
+
+/** Maximum number of frames that may be simulated again */
+#define NETPLAY_MAX_ROLLBACK    16
+/** Number of frames whose input is kept (must be greater than
+ * NETPLAY_MAX_ROLLBACK) */
+#define NETPLAY_HISTORY         64
+/** How many of the latest local inputs are sent on every packet, so a few lost
+ * packets don't delay the remote peer */
+#define NETPLAY_REDUNDANCY      8
+
+/** Channel where the local peer sends its input */
+#define NETPLAY_CHANNEL_OUT     0
+/** Channel where the local peer receives the remote input */
+#define NETPLAY_CHANNEL_IN      1
+
+struct stNetplayCtx {
+    /** State before each of the latest NETPLAY_MAX_ROLLBACK frames */
+    snapshotCtx *pSnapshots;
+    /** Playstate of the emulated remote peer */
+    snapshotCtx *pPeerState;
+    /** The local playstate, kept while the emulated peer is simulated */
+    snapshotCtx *pLocalState;
+    /** Hash of the local playstate after each frame */
+    uint32_t pHash[NETPLAY_HISTORY];
+    /** Local input on each frame */
+    uint8_t pLocal[NETPLAY_HISTORY];
+    /** Remote input used to simulate each frame (either confirmed or
+     * predicted) */
+    uint8_t pUsed[NETPLAY_HISTORY];
+    /** Remote input received for each frame */
+    uint8_t pRemote[NETPLAY_HISTORY];
+    /** Frame of each input on pRemote */
+    uint32_t pRemoteFrame[NETPLAY_HISTORY];
+    /** Time elapsed on each frame, in milliseconds */
+    int16_t pElapsed[NETPLAY_HISTORY];
+    /** Input last sent by the emulated remote peer */
+    uint8_t pPeer[NETPLAY_HISTORY];
+    /** Local input, as received by the emulated remote peer */
+    uint8_t pPeerLocal[NETPLAY_HISTORY];
+    /** Frame of each input on pPeerLocal */
+    uint32_t pPeerLocalFrame[NETPLAY_HISTORY];
+    /** Next frame to be simulated */
+    uint32_t frame;
+    /** First frame that may be rolled back to */
+    uint32_t base;
+    /** Next frame to be simulated by the emulated remote peer */
+    uint32_t peerFrame;
+    /** Hash of the emulated peer's latest frame (i.e., peerFrame - 1) */
+    uint32_t peerHash;
+    /** Latest remote frame whose hash still has to be checked */
+    uint32_t checkFrame;
+    /** Remote hash for checkFrame */
+    uint32_t checkHash;
+    /** First frame whose hash differed between the peers */
+    uint32_t desyncFrame;
+    /** Latest frame whose remote input was received */
+    uint32_t lastRemoteFrame;
+    /** Input received for lastRemoteFrame, used as the prediction */
+    uint8_t lastRemote;
+    /** Whether any remote input was received yet */
+    uint8_t didReceive;
+    /** Whether netplay is running */
+    uint8_t active;
+    /** Input used by the emulated peer on its previous frame */
+    uint8_t peerPrevLocal;
+    uint8_t peerPrevRemote;
+    /** Whether the emulated peer is simulating (it stops on level transitions,
+     * until the next level is loaded) */
+    uint8_t peerActive;
+    /** Whether checkFrame is still waiting to be checked */
+    uint8_t hasCheck;
+    /** How many frames were simulated again on the latest update */
+    int resimulated;
+    /** How many remote inputs arrived too late to be rolled back */
+    int lateInputs;
+    /** How many remote hashes differed from the local ones */
+    int desyncs;
+};
+typedef struct stNetplayCtx netplayCtx;
+
+/** The netplay session. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL netplayCtx netplay;
+
+/**
+ * Start a netplay session over the (previously configured) loopback transport.
+ * The local player controls swordy, and gunny is controlled by the emulated
+ * remote peer.
+ */
+err startNetplay();
+
+/** Stop the netplay session (if any) and release its memory */
+void stopNetplay();
+
+/** Forbid rolling back before the current frame (e.g., on a level load). The
+ * emulated peer restarts from the current playstate. */
+void resetNetplayRollback();
+
+/** Exchange the input for the current frame and simulate it (rolling back if
+ * any prediction was wrong) */
+err updateNetplay();
+
+#endif /* __JJAT2_NETPLAY_H__ */
@@ -5,6 +5,7 @@
 #define __JJAT2_PLAYSTATE_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 
 #include <GFraMe/gfmHitbox.h>
 #include <GFraMe/gfmObject.h>
@@ -13,6 +14,8 @@
 
 #include <jjat2/entity.h>
 #include <jjat2/leveltransition.h>
+#include <jjat2/tileview.h>
+#include <jjat2/world.h>
 
 #include <stdint.h>
 
@@ -24,12 +27,9 @@
 #define MAX_AREAS       16
 #define TILE_DIMENSION  8
 
-/** Maximum number of characters for the path to any given level */
+/** Maximum number of characters for the name of any given level (only used
+ * when reading a name from the command line) */
 #define MAX_LEVEL_NAME  128
-/** Maximum length for any level name. Since this is later modified (with prefix
- * and postfix), this length does NOT leave a free space for the trailing '\0' */
-#define MAX_VALID_LEN \
-    (MAX_LEVEL_NAME - (sizeof("levels/") - 1) - (sizeof("_bg_tm.gfm") - 1) - 1)
 
 union unHitboxCtx {
     leveltransitionData ltData;
@@ -44,9 +44,17 @@ struct stPlaystateCtx {
     gfmParser *pParser;
     /** The game's map */
     gfmTilemap *pMap;
+    /** 16-bit tile-query view of the map, i.e., a read-only copy of its tiles
+     * (the map is only modified while being loaded) */
+    tileView mapView;
 #if defined(JJAT_ENABLE_BACKGROUND)
     /** The game's background */
     gfmTilemap *pBackground;
+    /** Whether each of the background's tiles is animated, indexed by the
+     * tile. Built when the level is loaded. */
+    uint8_t *pBgAnimated;
+    /** Capacity of pBgAnimated, in tiles */
+    int bgAnimatedLen;
 #endif /* JJAT_ENABLE_BACKGROUND */
     /** Swordy character */
     entityCtx swordy;
@@ -69,13 +77,19 @@ struct stPlaystateCtx {
     uint8_t entityCount;
     /** Generic flags */
     uint8_t flags;
+    /** Players killed on the latest frame (as AC_SWORDY and AC_GUNNY) */
+    uint8_t killed;
     /** Context for the hitboxes */
     union unHitboxCtx data[MAX_AREAS];
+    /** The currently loaded level */
+    levelId level;
+    /** Level loaded when the game starts (FIRST_MAP, if LVL_NONE) */
+    levelId firstLevel;
 };
 typedef struct stPlaystateCtx playstateCtx;
 
 /** The game's playstate. Declared on src/jjat2/static.c. */
-extern playstateCtx playstate;
+extern SIM_LOCAL playstateCtx playstate;
 
 /** Initialize the playstate so a level may be later loaded and played */
 err initPlaystate();
@@ -97,6 +111,12 @@ err loadPlaystate();
 /** Remove the flag that signals that no level is being loaded */
 void clearPlaystateLevelFlag();
 
+/**
+ * Simulate a single frame of the playstate, from the current input and elapsed
+ * time
+ */
+err simulatePlaystate();
+
 /** Update the playstate */
 err updatePlaystate();
 
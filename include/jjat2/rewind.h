@@ -0,0 +1,92 @@
+/**
+ * @file include/jjat2/rewind.h
+ *
+ * Keep the last few seconds of the simulation, so it may be scrubbed backward.
+ *
+ * Every simulated frame is stored as a snapshot, XOR'ed against the latest
+ * keyframe (taken every REWIND_KEYFRAME_INTERVAL frames) and run-length
+ * encoded. Since most of the playstate doesn't change between frames, the
+ * XOR'ed snapshot is mostly zeros and gets encoded into a few bytes. The
+ * encoded frames are kept on a fixed-size ring; older frames are dropped to
+ * make room for newer ones.
+ *
+ * Just like snapshots, the rewind is only valid within a single level, so it's
+ * cleared whenever a level is loaded.
+ */
+#ifndef __JJAT2_REWIND_H__
+#define __JJAT2_REWIND_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <jjat2/snapshot.h>
+
+#include <stdint.h>
+
+/** Size of the ring of encoded frames, in bytes */
+#define REWIND_BUFFER_LEN           (1 << 20)
+/** Maximum number of frames kept (10 seconds, at 60 FPS) */
+#define REWIND_MAX_FRAMES           600
+/** How many frames there are between keyframes */
+#define REWIND_KEYFRAME_INTERVAL    60
+
+/** An encoded frame on the ring */
+struct stRewindFrame {
+    /** Where the frame starts on the ring */
+    uint32_t offset;
+    /** Length of the encoded frame */
+    uint32_t len;
+    /** Whether the frame was encoded by itself (instead of against the
+     * previous keyframe) */
+    uint8_t isKeyframe;
+};
+typedef struct stRewindFrame rewindFrame;
+
+struct stRewindCtx {
+    /** Ring of encoded frames (REWIND_BUFFER_LEN bytes) */
+    uint8_t *pBuf;
+    /** Encoded frame, before it's copied into the ring (or after it's copied
+     * out of it) */
+    uint8_t *pEncoded;
+    /** The frame being captured/restored */
+    snapshotCtx *pCur;
+    /** The keyframe of the latest frame */
+    snapshotCtx *pKeyframe;
+    /** Ring of frames, from the oldest to the latest */
+    rewindFrame pFrames[REWIND_MAX_FRAMES];
+    /** Where the oldest frame starts on pBuf */
+    uint32_t head;
+    /** How many bytes of pBuf are used */
+    uint32_t used;
+    /** Index of the oldest frame on pFrames */
+    int first;
+    /** How many frames there are on pFrames */
+    int count;
+    /** How many frames were captured since the latest keyframe (including
+     * the keyframe itself) */
+    int sinceKeyframe;
+};
+typedef struct stRewindCtx rewindCtx;
+
+/** The rewind buffer. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL rewindCtx rewindBuffer;
+
+/** Alloc the rewind buffer */
+err initRewind();
+
+/** Release the rewind buffer */
+void freeRewind();
+
+/** Drop every captured frame */
+void resetRewind();
+
+/** Store the current frame, dropping the oldest ones if necessary */
+err captureRewindFrame();
+
+/**
+ * Go back a single frame, restoring the playstate to how it was on the
+ * previous capture. If only a single frame is left, it's restored but kept.
+ */
+err rewindStep();
+
+#endif /* __JJAT2_REWIND_H__ */
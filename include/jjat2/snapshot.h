@@ -0,0 +1,128 @@
+/**
+ * @file include/jjat2/snapshot.h
+ *
+ * Store the whole playstate in memory (entities, effects, hitboxes, teleport
+ * target, camera, UI, signals and the checkpoint), so it may be later restored
+ * without reloading the level from disk. Restoring everything brings the
+ * simulation back to the same state (i.e., with the same getSimulationHash()).
+ * Animations are the exception: GFraMe can't seek within an animation, so they
+ * are played again from their start, only displaying the stored frame.
+ *
+ * Anything that doesn't change while a level is played (the tilemaps, the
+ * areas and the static quadtree) is kept as is. Therefore, a snapshot may only
+ * be restored while the level it was taken on is still loaded.
+ */
+#ifndef __JJAT2_SNAPSHOT_H__
+#define __JJAT2_SNAPSHOT_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <jjat2/entity.h>
+#include <jjat2/events/signal.h>
+#include <jjat2/fx_group.h>
+#include <jjat2/hitbox.h>
+#include <jjat2/leveltransition.h>
+#include <jjat2/playstate.h>
+#include <jjat2/teleport.h>
+
+#include <stdint.h>
+
+/** Which parts of a snapshot should be restored */
+enum enSnapshotPart {
+    /** Entities, effects, hitboxes, teleport target and signals */
+    SNAP_WORLD   = 0x01
+    /** Both players */
+  , SNAP_PLAYERS = 0x02
+    /** Flags that last through the whole session and the checkpoint */
+  , SNAP_SESSION = 0x04
+    /** Camera and UI */
+  , SNAP_VIEW    = 0x08
+  , SNAP_ALL     = 0x0f
+};
+typedef enum enSnapshotPart snapshotPart;
+
+/** An entity and the state of its sprite */
+struct stEntitySnapshot {
+    entityCtx ent;
+    spriteState spr;
+};
+typedef struct stEntitySnapshot entitySnapshot;
+
+struct stSnapshotCtx {
+    /** Level where the snapshot was taken (LVL_NONE if never taken) */
+    levelId level;
+    entitySnapshot swordy;
+    entitySnapshot gunny;
+    entitySnapshot entities[MAX_ENTITIES];
+    /** Every live effect, except for the teleport target */
+    fxState fx[MAX_FX_NUM];
+    /** Context for the areas */
+    union unHitboxCtx data[MAX_AREAS];
+    /** How every live hitbox was spawned */
+    hitboxState hitboxes[MAX_HITBOXES];
+    /** The latest checkpoint */
+    leveltransitionData checkpoint;
+    /** The teleport target. Its effect is spawned again on restore */
+    teleportCtx teleport;
+    /** State of the teleport target's effect, if any */
+    spriteState teleportSpr;
+    /** Which signals are raised (subscribers are set when the level is
+     * parsed, so they never change) */
+    signalState signals;
+    uint32_t sessionFlags;
+    uint32_t uiControl;
+    /** getSimulationHash() when the snapshot was taken */
+    uint32_t hash;
+    int cameraX;
+    int cameraY;
+    int cameraTween;
+    uint16_t fxCount;
+    uint16_t lastTouch;
+    uint8_t entityCount;
+    uint8_t flags;
+    uint8_t hitboxesUsed;
+    uint8_t hitboxesTmpUsed;
+};
+typedef struct stSnapshotCtx snapshotCtx;
+
+struct stSnapshotsCtx {
+    /** Taken as soon as a level finishes loading */
+    snapshotCtx level;
+#if defined(DEBUG)
+    /** Saved/loaded from the debug keys */
+    snapshotCtx debug;
+#endif /* DEBUG */
+};
+typedef struct stSnapshotsCtx snapshotsCtx;
+
+/** The game's snapshots. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL snapshotsCtx snapshots;
+
+/**
+ * Store the current playstate.
+ *
+ * @param  [out]pSnap The snapshot
+ */
+void takeSnapshot(snapshotCtx *pSnap);
+
+/**
+ * Check whether a snapshot may be restored (i.e., whether it was taken on the
+ * currently loaded level).
+ *
+ * @param  [ in]pSnap The snapshot
+ * @return            1 if valid, 0 otherwise
+ */
+int isSnapshotValid(snapshotCtx *pSnap);
+
+/**
+ * Restore the playstate from a snapshot. If every part gets restored, the
+ * simulation's hash is checked against the one from when the snapshot was
+ * taken, and ERR_SNAPSHOTMISMATCH is returned if they differ.
+ *
+ * @param  [ in]pSnap The snapshot
+ * @param  [ in]parts Bitmask of snapshotPart, selecting what gets restored
+ */
+err restoreSnapshot(snapshotCtx *pSnap, int parts);
+
+#endif /* __JJAT2_SNAPSHOT_H__ */
@@ -11,6 +11,8 @@
 #ifndef __JJAT2_TELEPORT_H__
 #define __JJAT2_TELEPORT_H__
 
+#include <base/simulation.h>
+
 #include <GFraMe/gfmGroup.h>
 
 #include <jjat2/entity.h>
@@ -27,11 +29,16 @@ struct stTeleportCtx {
     gfmGroupNode *pCurEffect;
     /** The current target (if an entity) */
     entityCtx *pTarget;
+    /** Target's center (if not an entity) */
+    int x;
+    int y;
+    /** 'Relative' position of the target */
+    teleportPosition pos;
 };
 typedef struct stTeleportCtx teleportCtx;
 
 /** The current target (if an entity) */
-extern teleportCtx teleport;
+extern SIM_LOCAL teleportCtx teleport;
 
 /** Remove the previous target */
 void resetTeleporterTarget();
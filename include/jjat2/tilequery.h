@@ -0,0 +1,119 @@
+/**
+ * @file include/jjat2/tilequery.h
+ *
+ * Query the level's tilemap (i.e., playstate.pMap) directly, without going
+ * through the quadtree. Useful for questions such as "what's the first floor
+ * along this line" or "is there any floor ahead", which would otherwise
+ * require spawning a hitbox.
+ *
+ * Tiles are read from playstate.mapView (see jjat2/tileview.h) and their types
+ * are looked up on a table built when the level is loaded, indexed directly by
+ * the tile, so checking a tile costs a couple of array loads.
+ *
+ * Every query accepts a filter: either a base type (e.g., T_FLOOR, which also
+ * matches T_FLOOR_NOTP and T_BLUE_PLATFORM), TQ_ANY, which matches every tile
+ * with a type, or TQ_SOLID, which only matches tiles entities currently collide
+ * against. Positions outside the tilemap never match.
+ */
+#ifndef __JJAT2_TILEQUERY_H__
+#define __JJAT2_TILEQUERY_H__
+
+#include <base/error.h>
+#include <base/simulation.h>
+
+#include <stdint.h>
+
+/** Filter that matches every tile with a type */
+#define TQ_ANY      0
+/** Filter that matches every floor that currently collides (i.e., blue
+ * platforms are only matched after they get activated) */
+#define TQ_SOLID    -1
+
+/** Where a query found a tile */
+struct stTileHit {
+    /** Position of the tile, in tiles */
+    int tileX;
+    int tileY;
+    /** Where the tile was touched, in pixels. For a sweep, this is the box's
+     * position when it touched the tile. */
+    int x;
+    int y;
+    /** Type of the tile */
+    int type;
+    /** Whether the tile was touched from above or from below (otherwise, it
+     * was touched from one of its sides or the query started on it) */
+    int vertical;
+};
+typedef struct stTileHit tileHit;
+
+struct stTileTypesCtx {
+    /** Type of every tile used by the current level, indexed by the tile */
+    uint8_t *pTypes;
+    /** Capacity of pTypes, in tiles */
+    int typesLen;
+    /** Number of entries on pTypes (i.e., the greatest tile plus one) */
+    int count;
+};
+typedef struct stTileTypesCtx tileTypesCtx;
+
+/** The tile types of the current level. Declared on src/jjat2/static.c. */
+extern SIM_LOCAL tileTypesCtx tileTypes;
+
+/** Build the type table for the currently loaded tilemap (playstate.pMap),
+ * after its view (playstate.mapView) got synced */
+err buildTileTypes();
+
+/** Release the type table */
+void freeTileTypes();
+
+/**
+ * Retrieve the type of a tile.
+ *
+ * @param  [ in]tileX The tile's position, in tiles
+ * @param  [ in]tileY The tile's position, in tiles
+ * @return            The tile's type (0 if none or outside the tilemap)
+ */
+int getTileType(int tileX, int tileY);
+
+/**
+ * Check whether the tile on a given position matches the filter.
+ *
+ * @param  [ in]x      The position, in pixels
+ * @param  [ in]y      The position, in pixels
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ * @return             1 if there's a matching tile, 0 otherwise
+ */
+int isTileAt(int x, int y, int filter);
+
+/**
+ * Walk every tile crossed by a segment (from its first point to the last),
+ * stopping on the first one that matches the filter.
+ *
+ * @param  [out]pHit   The first matching tile (may be NULL)
+ * @param  [ in]x0     The segment's first point, in pixels
+ * @param  [ in]y0     The segment's first point, in pixels
+ * @param  [ in]x1     The segment's last point, in pixels
+ * @param  [ in]y1     The segment's last point, in pixels
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ * @return             1 if a tile was found, 0 otherwise
+ */
+int raycastTiles(tileHit *pHit, int x0, int y0, int x1, int y1, int filter);
+
+/**
+ * Move a box along a displacement, stopping on the first tile it touches that
+ * matches the filter. Tiles already overlapped by the box are ignored.
+ *
+ * @param  [out]pHit   The first matching tile (may be NULL)
+ * @param  [ in]x      The box's position, in pixels
+ * @param  [ in]y      The box's position, in pixels
+ * @param  [ in]w      The box's dimensions, in pixels
+ * @param  [ in]h      The box's dimensions, in pixels
+ * @param  [ in]dx     The displacement, in pixels
+ * @param  [ in]dy     The displacement, in pixels
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ * @return             1 if a tile was found, 0 otherwise
+ */
+int sweepTiles(tileHit *pHit, int x, int y, int w, int h, int dx, int dy
+        , int filter);
+
+#endif /* __JJAT2_TILEQUERY_H__ */
@@ -0,0 +1,68 @@
+/**
+ * @file include/jjat2/tileview.h
+ *
+ * A 16-bit tile-query view: a read-only copy of a tilemap's tiles, for code
+ * that walks them (e.g., tile queries and the idle-frame check).
+ *
+ * The tilemap itself isn't narrowed: GFraMe still stores (and renders from) an
+ * int for every tile, so a view costs two extra bytes per tile. In exchange,
+ * walking the view touches half as much memory as walking GFraMe's data.
+ *
+ * Views are only synced when requested (i.e., when a level is loaded), so they
+ * shouldn't be used for tilemaps modified afterwards (e.g., animated ones).
+ */
+#ifndef __JJAT2_TILEVIEW_H__
+#define __JJAT2_TILEVIEW_H__
+
+#include <base/error.h>
+
+#include <GFraMe/gfmTilemap.h>
+
+#include <stdint.h>
+
+/** Tile stored for empty (i.e., negative) tiles and outside the view */
+#define TILE_VIEW_EMPTY 0xffff
+
+struct stTileView {
+    /** Every tile, row by row */
+    uint16_t *pTiles;
+    /** Capacity of pTiles, in tiles */
+    int len;
+    /** Dimensions of the tilemap, in tiles */
+    int width;
+    int height;
+};
+typedef struct stTileView tileView;
+
+/**
+ * Copy every tile from a tilemap into a view.
+ *
+ * @param  [ in]pView    The view
+ * @param  [ in]pTilemap The tilemap
+ */
+err syncTileView(tileView *pView, gfmTilemap *pTilemap);
+
+/**
+ * Release a view.
+ *
+ * @param  [ in]pView The view
+ */
+void freeTileView(tileView *pView);
+
+/**
+ * Retrieve a tile from a view.
+ *
+ * @param  [ in]pView The view
+ * @param  [ in]tileX The tile's position, in tiles
+ * @param  [ in]tileY The tile's position, in tiles
+ * @return            The tile (TILE_VIEW_EMPTY if empty or outside the view)
+ */
+static inline int getTileViewAt(tileView *pView, int tileX, int tileY) {
+    if (tileX < 0 || tileY < 0 || tileX >= pView->width
+            || tileY >= pView->height) {
+        return TILE_VIEW_EMPTY;
+    }
+    return pView->pTiles[tileX + tileY * pView->width];
+}
+
+#endif /* __JJAT2_TILEVIEW_H__ */
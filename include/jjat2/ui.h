@@ -9,6 +9,7 @@
 #define __JJAT2_UI_H__
 
 #include <base/error.h>
+#include <base/simulation.h>
 
 #include <GFraMe/gfmTilemap.h>
 
@@ -45,7 +46,7 @@ struct stUICtx {
 typedef struct stUICtx uiCtx;
 
 /** The UI context */
-extern uiCtx ui;
+extern SIM_LOCAL uiCtx ui;
 
 /** Initialize the UI */
 err initUI();
@@ -61,7 +62,7 @@ void resetUI();
  *
  * @param  [ in]title The title
  */
-void setMapTitle(char *title);
+void setMapTitle(const char *title);
 
 /** Starts tweening the view in. If it's already visible, reset the countdown to
  * hide it */
@@ -90,6 +91,15 @@ void setSwordyLife(int cur, int max);
  */
 void setGunnyLife(int cur, int max);
 
+/**
+ * Accumulate everything that affects how the UI is rendered into a hash, so
+ * changes may be detected between frames.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashUI(uint32_t hash);
+
 /** Update the UI position */
 err updateUI();
 
@@ -0,0 +1,57 @@
+/**
+ * @file include/jjat2/world.h
+ *
+ * Every level in the world, as listed on conf/level_list.h. Each level is
+ * identified by a small number (its levelId), and the paths to its files are
+ * built at compile time, so transitions never have to handle strings.
+ */
+#ifndef __JJAT2_WORLD_H__
+#define __JJAT2_WORLD_H__
+
+#include <base/error.h>
+#include <conf/level_list.h>
+
+#include <stdint.h>
+
+enum enLevelId {
+    /** No level (e.g., a loadzone without a destination) */
+    LVL_NONE = 0
+#define X(id, name, song) , id
+    LEVELS_LIST
+#undef X
+  , LVL_COUNT
+};
+/** A level, stored with a fixed size. Should be one of enLevelId */
+typedef uint16_t levelId;
+
+/** The files of a level, within the game's assets */
+struct stLevelManifest {
+    /** The level's name (e.g., "lab/awakening_passage") */
+    char *pName;
+    /** Path to the foreground tilemap */
+    char *pFgPath;
+    /** Path to the background tilemap */
+    char *pBgPath;
+    /** Path to the objects */
+    char *pObjPath;
+    /** Song played by the level's objects (empty if none) */
+    char *pSong;
+    /** Length of each path, without the '\0' */
+    int fgLen;
+    int bgLen;
+    int objLen;
+};
+typedef struct stLevelManifest levelManifest;
+
+/** Manifest of every level, indexed by its levelId (LVL_NONE is empty) */
+extern const levelManifest pLevels[LVL_COUNT];
+
+/**
+ * Retrieve a level by its name.
+ *
+ * @param  [out]pId   The level
+ * @param  [ in]pName The level's name (e.g., "lab/awakening_passage")
+ */
+err getLevelId(levelId *pId, const char *pName);
+
+#endif /* __JJAT2_WORLD_H__ */
@@ -111,7 +111,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_BLUE_PLATFORM, T_FLOOR)
     IGNORE(T_BLUE_PLATFORM, T_FLOOR_NOTP)
     IGNORE(T_BLUE_PLATFORM, T_FLOOR_SKIP_TP)
-    IGNORE(T_BLUE_PLATFORM, T_EN_G_WALKY_VIEW)
     IGNORE(T_BLUE_PLATFORM, T_PRESSURE_PAD)
     IGNORE(T_FLOOR, T_ATK_SWORD)
     IGNORE(T_FLOOR, T_CHECKPOINT)
@@ -123,7 +122,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     SELFCASE(T_FLOOR)
     IGNORE(T_FLOOR, T_FLOOR_NOTP)
     IGNORE(T_FLOOR, T_FLOOR_SKIP_TP)
-    IGNORE(T_FLOOR, T_EN_G_WALKY_VIEW)
     IGNORE(T_FLOOR, T_PRESSURE_PAD)
     IGNORE(T_FLOOR_NOTP, T_ATK_SWORD)
     IGNORE(T_FLOOR_NOTP, T_CHECKPOINT)
@@ -135,7 +133,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_FLOOR_NOTP, T_FLOOR)
     SELFCASE(T_FLOOR_NOTP)
     IGNORE(T_FLOOR_NOTP, T_FLOOR_SKIP_TP)
-    IGNORE(T_FLOOR_NOTP, T_EN_G_WALKY_VIEW)
     IGNORE(T_FLOOR_NOTP, T_PRESSURE_PAD)
     IGNORE(T_FLOOR_SKIP_TP, T_ATK_SWORD)
     IGNORE(T_FLOOR_SKIP_TP, T_CHECKPOINT)
@@ -147,7 +144,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_FLOOR_SKIP_TP, T_FLOOR)
     IGNORE(T_FLOOR_SKIP_TP, T_FLOOR_NOTP)
     SELFCASE(T_FLOOR_SKIP_TP)
-    IGNORE(T_FLOOR_SKIP_TP, T_EN_G_WALKY_VIEW)
     IGNORE(T_FLOOR_SKIP_TP, T_PRESSURE_PAD)
     IGNORE(T_DOOR, T_ATK_SWORD)
     IGNORE(T_DOOR, T_CHECKPOINT)
@@ -159,7 +155,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_DOOR, T_FLOOR)
     IGNORE(T_DOOR, T_FLOOR_NOTP)
     IGNORE(T_DOOR, T_FLOOR_SKIP_TP)
-    IGNORE(T_DOOR, T_EN_G_WALKY_VIEW)
     IGNORE(T_DOOR, T_PRESSURE_PAD)
         erv = ERR_OK;
     break;
@@ -204,7 +199,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_EN_G_WALKY_ATK, T_DUMMY_SWORDY)
     IGNORE(T_EN_G_WALKY_ATK, T_DUMMY_GUNNY)
     SELFCASE(T_EN_G_WALKY_ATK)
-    IGNORE(T_EN_G_WALKY_ATK, T_EN_G_WALKY_VIEW)
     IGNORE(T_EN_G_WALKY_ATK, T_PRESSURE_PAD)
         erv = ERR_OK;
     break;
@@ -215,7 +209,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_SWORD_FX, T_EN_WALKY)
     IGNORE(T_SWORD_FX, T_EN_G_WALKY)
     IGNORE(T_SWORD_FX, T_EN_G_WALKY_ATK)
-    IGNORE(T_SWORD_FX, T_EN_G_WALKY_VIEW)
     IGNORE(T_SWORD_FX, T_EN_TURRET)
     IGNORE(T_SWORD_FX, T_SWORDY)
     IGNORE(T_SWORD_FX, T_GUNNY)
@@ -236,7 +229,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_FX, T_EN_WALKY)
     IGNORE(T_FX, T_EN_G_WALKY)
     IGNORE(T_FX, T_EN_G_WALKY_ATK)
-    IGNORE(T_FX, T_EN_G_WALKY_VIEW)
     IGNORE(T_FX, T_EN_TURRET)
     IGNORE(T_FX, T_SWORDY)
     IGNORE(T_FX, T_GUNNY)
@@ -265,8 +257,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_EN_G_WALKY, T_FX)
     IGNORE(T_EN_G_WALKY_ATK, T_SWORD_FX)
     IGNORE(T_EN_G_WALKY_ATK, T_FX)
-    IGNORE(T_EN_G_WALKY_VIEW, T_SWORD_FX)
-    IGNORE(T_EN_G_WALKY_VIEW, T_FX)
     IGNORE(T_EN_TURRET, T_SWORD_FX)
     IGNORE(T_EN_TURRET, T_FX)
     IGNORE(T_SWORDY, T_SWORD_FX)
@@ -370,7 +360,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_ATK_SWORD, T_FLOOR_NOTP)
     IGNORE(T_ATK_SWORD, T_SPIKE)
     IGNORE(T_ATK_SWORD, T_LOADZONE)
-    IGNORE(T_ATK_SWORD, T_EN_G_WALKY_VIEW)
     IGNORE(T_ATK_SWORD, T_BLUE_PLATFORM)
     IGNORE(T_ATK_SWORD, T_DUMMY_SWORDY)
     IGNORE(T_ATK_SWORD, T_DUMMY_GUNNY)
@@ -434,7 +423,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_SPIKE, T_DUMMY_SWORDY)
     IGNORE(T_SPIKE, T_DUMMY_GUNNY)
     SELFCASE(T_SPIKE)
-    IGNORE(T_SPIKE, T_EN_G_WALKY_VIEW)
     IGNORE(T_SPIKE, T_PRESSURE_PAD)
     IGNORE(T_SPIKE, T_FLOOR_SKIP_TP)
         erv = ERR_OK;
@@ -504,28 +492,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
             erv = _onPressurePad(&node2, &node1);
         }
     break;
-    CASE(T_EN_SPIKY, T_EN_G_WALKY_VIEW)
-    CASE(T_EN_WALKY, T_EN_G_WALKY_VIEW)
-    CASE(T_EN_G_WALKY, T_EN_G_WALKY_VIEW)
-    CASE(T_EN_TURRET, T_EN_G_WALKY_VIEW)
-    CASE(T_SWORDY, T_EN_G_WALKY_VIEW)
-    CASE(T_GUNNY, T_EN_G_WALKY_VIEW)
-        if (node1.pChild != node2.pChild) {
-            /* Filter out self collision */
-            erv = _gWalkyViewEntityCollision(&node1, &node2);
-        }
-    break;
-    CASE(T_EN_G_WALKY_VIEW, T_EN_SPIKY)
-    CASE(T_EN_G_WALKY_VIEW, T_EN_WALKY)
-    CASE(T_EN_G_WALKY_VIEW, T_EN_G_WALKY)
-    CASE(T_EN_G_WALKY_VIEW, T_EN_TURRET)
-    CASE(T_EN_G_WALKY_VIEW, T_SWORDY)
-    CASE(T_EN_G_WALKY_VIEW, T_GUNNY)
-        if (node1.pChild != node2.pChild) {
-            /* Filter out self collision */
-            erv = _gWalkyViewEntityCollision(&node2, &node1);
-        }
-    break;
     /* Collision group 'dummy_collision' */ 
     CASE(T_DUMMY_GUNNY, T_SWORDY)
     CASE(T_DUMMY_GUNNY, T_GUNNY)
@@ -560,7 +526,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_DUMMY_GUNNY, T_EN_WALKY)
     IGNORE(T_DUMMY_GUNNY, T_EN_G_WALKY)
     IGNORE(T_DUMMY_GUNNY, T_EN_G_WALKY_ATK)
-    IGNORE(T_DUMMY_GUNNY, T_EN_G_WALKY_VIEW)
     IGNORE(T_DUMMY_GUNNY, T_EN_SPIKY)
     IGNORE(T_DUMMY_GUNNY, T_EN_TURRET)
     IGNORE(T_DUMMY_GUNNY, T_BLUE_PLATFORM)
@@ -579,7 +544,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_DUMMY_SWORDY, T_EN_WALKY)
     IGNORE(T_DUMMY_SWORDY, T_EN_G_WALKY)
     IGNORE(T_DUMMY_SWORDY, T_EN_G_WALKY_ATK)
-    IGNORE(T_DUMMY_SWORDY, T_EN_G_WALKY_VIEW)
     IGNORE(T_DUMMY_SWORDY, T_EN_SPIKY)
     IGNORE(T_DUMMY_SWORDY, T_EN_TURRET)
     IGNORE(T_DUMMY_SWORDY, T_BLUE_PLATFORM)
@@ -594,26 +558,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
             erv = _onPressurePad(&node1, &node2);
         }
     break;
-    /* Collision group 'g_walky_view' */ 
-#  if defined(DEBUG) && !(defined(__WIN32) || defined(__WIN32__))
-    IGNORE(T_EN_G_WALKY_VIEW, T_FLOOR)
-    IGNORE(T_EN_G_WALKY_VIEW, T_FLOOR_NOTP)
-    IGNORE(T_EN_G_WALKY_VIEW, T_LOADZONE)
-    IGNORE(T_EN_G_WALKY_VIEW, T_BLUE_PLATFORM)
-    IGNORE(T_EN_G_WALKY_VIEW, T_ATK_SWORD)
-    IGNORE(T_EN_G_WALKY_VIEW, T_TEL_BULLET)
-    IGNORE(T_EN_G_WALKY_VIEW, T_CHECKPOINT)
-    IGNORE(T_EN_G_WALKY_VIEW, T_DUMMY_SWORDY)
-    IGNORE(T_EN_G_WALKY_VIEW, T_DUMMY_GUNNY)
-    IGNORE(T_EN_G_WALKY_VIEW, T_SPIKE)
-    IGNORE(T_EN_G_WALKY_VIEW, T_EN_G_WALKY_ATK)
-    SELFCASE(T_EN_G_WALKY_VIEW)
-    IGNORE(T_EN_G_WALKY_VIEW, T_DOOR)
-    IGNORE(T_EN_G_WALKY_VIEW, T_PRESSURE_PAD)
-    IGNORE(T_EN_G_WALKY_VIEW, T_FLOOR_SKIP_TP)
-        erv = ERR_OK;
-    break;
-#  endif /* defined(DEBUG) && !(defined(__WIN32) || defined(__WIN32__)) */
     /* Collision group 'checkpoint_collision' */ 
     CASE(T_CHECKPOINT, T_GUNNY)
     CASE(T_CHECKPOINT, T_SWORDY)
@@ -643,7 +587,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_CHECKPOINT, T_EN_WALKY)
     IGNORE(T_CHECKPOINT, T_EN_G_WALKY)
     IGNORE(T_CHECKPOINT, T_EN_G_WALKY_ATK)
-    IGNORE(T_CHECKPOINT, T_EN_G_WALKY_VIEW)
     IGNORE(T_CHECKPOINT, T_EN_SPIKY)
     IGNORE(T_CHECKPOINT, T_EN_TURRET)
     IGNORE(T_CHECKPOINT, T_PRESSURE_PAD)
@@ -707,7 +650,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_TEL_BULLET, T_EN_G_WALKY_ATK)
     IGNORE(T_TEL_BULLET, T_CHECKPOINT)
     IGNORE(T_TEL_BULLET, T_LOADZONE)
-    IGNORE(T_TEL_BULLET, T_EN_G_WALKY_VIEW)
     IGNORE(T_TEL_BULLET, T_DUMMY_SWORDY)
     IGNORE(T_TEL_BULLET, T_DUMMY_GUNNY)
     IGNORE(T_TEL_BULLET, T_PRESSURE_PAD)
@@ -757,7 +699,6 @@ switch (MERGE_TYPES(node1.type, node2.type)) {
     IGNORE(T_LOADZONE, T_EN_WALKY)
     IGNORE(T_LOADZONE, T_EN_G_WALKY)
     IGNORE(T_LOADZONE, T_EN_G_WALKY_ATK)
-    IGNORE(T_LOADZONE, T_EN_G_WALKY_VIEW)
     IGNORE(T_LOADZONE, T_EN_SPIKY)
     IGNORE(T_LOADZONE, T_EN_TURRET)
     IGNORE(T_LOADZONE, T_PRESSURE_PAD)
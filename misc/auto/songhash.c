@@ -0,0 +1,25 @@
+/**
+ * @file misc/auto/songhash.c
+ *
+ * File generated from 'include/conf/sfx_list.h' to look up songs by
+ * their name in constant time
+ *
+ * DO NOT EDIT MANUALLY
+ */
+
+/** Seed used to hash the name of a song */
+#define SONG_HASH_SEED 0x811c9dc5u
+/** Number of slots on the table (a power of two) */
+#define SONG_HASH_SIZE 8
+
+/** Index of each song within SONGS_LIST (or -1, if the slot is empty) */
+static const int _songHashTable[SONG_HASH_SIZE] = {
+    -1
+  ,  0 /* intro.mml */
+  , -1
+  ,  1 /* first-steps.mml */
+  , -1
+  ,  2 /* starting-to-move.mml */
+  , -1
+  , -1
+};
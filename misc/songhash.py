@@ -0,0 +1,138 @@
+""" Reads 'include/conf/sfx_list.h' and generates a perfect hash table for
+looking up songs by their file name.
+
+The hash is a FNV-1a (the same implemented on 'include/base/hash.h'), whose
+seed is searched until every song maps into a different slot of the table.
+"""
+
+import os
+import re
+import shutil
+import sys
+import tempfile
+
+# Same constants used by 'include/base/hash.h'
+HASH_INIT = 2166136261
+HASH_PRIME = 16777619
+# Give up after this many seeds
+MAX_SEEDS = 1000000
+
+def fnv1a(seed, string):
+    h = seed
+    for c in bytearray(string.encode('ascii')):
+        h ^= c
+        h = (h * HASH_PRIME) & 0xffffffff
+    return h
+
+def read_songs(header_filename):
+    """ Retrieve the list of songs' files, in the order they were declared """
+    fp = open(header_filename, 'rt')
+    try:
+        lines = fp.readlines()
+    finally:
+        fp.close()
+
+    songs = []
+    in_list = False
+    for line in lines:
+        if not in_list:
+            in_list = line.startswith('#define SONGS_LIST')
+            if in_list and not line.rstrip().endswith('\\'):
+                # Empty list
+                break
+            continue
+        m = re.match(r'\s*X\(\s*\w+\s*,\s*"([^"]*)"\s*\)', line)
+        if m is not None:
+            songs.append(m.group(1))
+        if not line.rstrip().endswith('\\'):
+            break
+    return songs
+
+def find_seed(songs, size):
+    """ Look for a seed that maps every song into a different slot """
+    seed = HASH_INIT
+    for i in range(MAX_SEEDS):
+        slots = [fnv1a(seed, s) & (size - 1) for s in songs]
+        if len(set(slots)) == len(slots):
+            return seed, slots
+        seed = (seed + 1) & 0xffffffff
+    return None, None
+
+def main(header_filename, out_file):
+    try:
+        songs = read_songs(header_filename)
+    except Exception as e:
+        print('Failed to read the list of songs: {}'.format(e))
+        return 3
+
+    # Use a power of two at least twice as big as the list, so a seed is
+    # quickly found and the lookup may simply mask the hash
+    size = 1
+    while size < len(songs) * 2:
+        size *= 2
+
+    seed, slots = find_seed(songs, size)
+    if seed is None:
+        print('Failed to find a perfect hash for {} songs'.format(len(songs)))
+        return 4
+
+    table = [-1] * size
+    for idx, slot in enumerate(slots):
+        table[slot] = idx
+
+    out_file.write('/** Seed used to hash the name of a song */\n')
+    out_file.write('#define SONG_HASH_SEED 0x{:08x}u\n'.format(seed))
+    out_file.write('/** Number of slots on the table (a power of two) */\n')
+    out_file.write('#define SONG_HASH_SIZE {}\n\n'.format(size))
+    out_file.write('/** Index of each song within SONGS_LIST (or -1, if the slot is empty) */\n')
+    out_file.write('static const int _songHashTable[SONG_HASH_SIZE] = {\n')
+    for slot, idx in enumerate(table):
+        name = songs[idx] if idx != -1 else ''
+        sep = ' ' if slot == 0 else ','
+        out_file.write('  {} {:>2} /* {} */\n'.format(sep, idx, name).replace(' /*  */', ''))
+    out_file.write('};\n')
+    return 0
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print('Expected two arguments!')
+        print('Usage: {} sfx_list_header output_filename'.format(sys.argv[0]))
+        sys.exit(1)
+
+    if sys.argv[2] != 'stdout':
+        try:
+            fp = tempfile.NamedTemporaryFile(mode='wt', delete=False)
+            filepath = fp.name
+        except Exception as e:
+            print('Failed to open output file: {}'.format(e))
+            sys.exit(2)
+    else:
+        fp = sys.stdout
+
+    fp.write('/**\n'
+             ' * @file {}\n'.format(sys.argv[2]) +
+             ' *\n'
+             ' * File generated from \'include/conf/sfx_list.h\' to look up songs by\n'
+             ' * their name in constant time\n'
+             ' *\n'
+             ' * DO NOT EDIT MANUALLY\n'
+             ' */\n\n')
+
+    rv = main(sys.argv[1], fp)
+    fp.close()
+
+    # Move the file to its final destination
+    if rv == 0 and sys.argv[2] != 'stdout':
+        try:
+            os.remove(sys.argv[2])
+        except:
+            pass
+        try:
+            shutil.move(filepath, sys.argv[2])
+        except Exception as e:
+            print('Failed to create the output file: {}'.format(e))
+            rv = 7
+    elif sys.argv[2] != 'stdout':
+        os.remove(filepath)
+
+    sys.exit(rv)
@@ -0,0 +1,394 @@
+/**
+ * @file src/base/batch.c
+ *
+ * Run many headless simulations in parallel and report how each of them went.
+ *
+ * Jobs are picked by the workers from a shared counter, so a worker that
+ * finishes a short job early simply takes the next one. The results are only
+ * read by the main thread after every worker is joined.
+ */
+#include <base/atomic.h>
+#include <base/batch.h>
+#include <base/clock.h>
+#include <base/error.h>
+#include <base/game.h>
+#include <conf/game.h>
+
+#include <GFraMe/gframe.h>
+#include <GFraMe/gfmCamera.h>
+#include <GFraMe/gfmError.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__WIN32) || defined(__WIN32__)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+#define LOG(...) printf(__VA_ARGS__)
+
+/** Retrieve how many cores are available */
+static int _getCoreCount() {
+#if defined(__WIN32) || defined(__WIN32__)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+/**
+ * Skip every whitespace.
+ *
+ * @param  [ in]pStr The string
+ */
+static char* _skipBlanks(char *pStr) {
+    while (*pStr == ' ' || *pStr == '\t' || *pStr == '\r') {
+        pStr++;
+    }
+    return pStr;
+}
+
+/**
+ * Terminate the current token, retrieving where the following one starts.
+ *
+ * @param  [ in]pStr The token
+ */
+static char* _endToken(char *pStr) {
+    while (*pStr != '\0' && *pStr != ' ' && *pStr != '\t' && *pStr != '\r') {
+        pStr++;
+    }
+    if (*pStr != '\0') {
+        *pStr = '\0';
+        pStr++;
+    }
+    return pStr;
+}
+
+/**
+ * Parse every job from the list (which is modified in place).
+ *
+ * @param  [ in]maxJobs How many jobs fit on batch.pJobs
+ */
+static err _parseJobs(int maxJobs) {
+    char *pCur = batch.pText;
+
+    while (*pCur != '\0') {
+        char *pLine, *pNext;
+
+        pLine = _skipBlanks(pCur);
+        pNext = strchr(pLine, '\n');
+        if (pNext != 0) {
+            *pNext = '\0';
+            pNext++;
+        }
+        else {
+            pNext = pLine + strlen(pLine);
+        }
+
+        if (*pLine != '\0' && *pLine != '#') {
+            batchJob *pJob;
+            char *pTmp;
+
+            ASSERT(batch.count < maxJobs, ERR_INDEXOOB);
+            pJob = &batch.pJobs[batch.count];
+            memset(pJob, 0x0, sizeof(batchJob));
+
+            pJob->pLevel = pLine;
+            pTmp = _skipBlanks(_endToken(pLine));
+            ASSERT(*pTmp != '\0', ERR_PARSINGERR);
+            pJob->pReplay = pTmp;
+            pTmp = _skipBlanks(_endToken(pTmp));
+            ASSERT(*pTmp == '\0', ERR_PARSINGERR);
+
+            pJob->divergedAt = -1;
+            batch.count++;
+        }
+
+        pCur = pNext;
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Load the list of jobs.
+ *
+ * @param  [ in]pPath   The job list
+ * @param  [ in]workers How many workers should be used (0 uses one for each
+ *                      core)
+ */
+err initBatch(char *pPath, int workers) {
+    FILE *pFile;
+    long len;
+    int i, lines;
+    err erv;
+
+    ASSERT(pPath != 0, ERR_ARGUMENTBAD);
+    ASSERT(workers >= 0, ERR_ARGUMENTBAD);
+    ASSERT(batch.pJobs == 0, ERR_ARGUMENTBAD);
+
+    pFile = fopen(pPath, "rb");
+    ASSERT(pFile != 0, ERR_OPENFILE);
+    fseek(pFile, 0, SEEK_END);
+    len = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    ASSERT_TO(len >= 0, erv = ERR_OPENFILE, __ret);
+
+    batch.pText = malloc(len + 1);
+    ASSERT_TO(batch.pText != 0, erv = ERR_OOM, __ret);
+    ASSERT_TO(fread(batch.pText, 1, len, pFile) == (size_t)len
+            , erv = ERR_OPENFILE, __ret);
+    batch.pText[len] = '\0';
+
+    /* There's at most a job for each line */
+    lines = 1;
+    for (i = 0; i < len; i++) {
+        if (batch.pText[i] == '\n') {
+            lines++;
+        }
+    }
+    batch.pJobs = malloc(sizeof(batchJob) * lines);
+    ASSERT_TO(batch.pJobs != 0, erv = ERR_OOM, __ret);
+
+    erv = _parseJobs(lines);
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+
+    if (workers == 0) {
+        workers = _getCoreCount();
+    }
+    if (workers > batch.count) {
+        workers = batch.count;
+    }
+    if (workers > BATCH_MAX_WORKERS) {
+        workers = BATCH_MAX_WORKERS;
+    }
+    if (workers < 1) {
+        workers = 1;
+    }
+    batch.workers = workers;
+
+    erv = ERR_OK;
+__ret:
+    fclose(pFile);
+
+    return erv;
+}
+
+/** Release every job */
+void freeBatch() {
+    free(batch.pJobs);
+    free(batch.pText);
+    batch.pJobs = 0;
+    batch.pText = 0;
+    batch.count = 0;
+}
+
+/**
+ * Run jobs until every one was taken.
+ *
+ * @param  [ in]pWorker The worker
+ */
+static void _runWorker(batchWorker *pWorker) {
+    /* Bind the worker's context to this thread's simulation */
+    game.pCtx = pWorker->pCtx;
+    game.pCamera = pWorker->pCamera;
+    game.flags = batch.flags;
+
+    while (1) {
+        batchJob *pJob;
+        int idx;
+
+        idx = ATOMIC_FETCH_ADD(&batch.next, 1);
+        if (idx >= batch.count) {
+            break;
+        }
+
+        pJob = &batch.pJobs[idx];
+        pJob->result = simulateBatchJob(pJob);
+    }
+
+    game.pCtx = 0;
+    game.pCamera = 0;
+}
+
+#if defined(__WIN32) || defined(__WIN32__)
+static DWORD WINAPI _workerThread(LPVOID pArg) {
+    _runWorker((batchWorker*)pArg);
+    return 0;
+}
+#else
+static void* _workerThread(void *pArg) {
+    _runWorker((batchWorker*)pArg);
+    return 0;
+}
+#endif
+
+/**
+ * Alloc a worker's context. Since GFraMe isn't guaranteed to be thread-safe
+ * while initializing, this is done on the main thread.
+ *
+ * @param  [ in]pWorker The worker
+ */
+static err _initWorker(batchWorker *pWorker) {
+    gfmRV rv;
+
+    rv = gfm_getNew(&pWorker->pCtx);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    rv = gfm_initStatic(pWorker->pCtx, ORG, TITLE);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+
+    /* Without a window, the camera must be set up manually */
+    rv = gfm_getCamera(&pWorker->pCamera, pWorker->pCtx);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    rv = gfmCamera_init(pWorker->pCamera, pWorker->pCtx, V_WIDTH, V_HEIGHT);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+
+    return ERR_OK;
+}
+
+/**
+ * Start a worker's thread.
+ *
+ * @param  [ in]pWorker The worker
+ */
+static err _startWorker(batchWorker *pWorker) {
+#if defined(__WIN32) || defined(__WIN32__)
+    pWorker->hThread = CreateThread(0, 0, _workerThread, pWorker, 0, 0);
+    ASSERT(pWorker->hThread != 0, ERR_OOM);
+#else
+    ASSERT(pthread_create(&pWorker->thread, 0, _workerThread, pWorker) == 0
+            , ERR_OOM);
+#endif
+    pWorker->isRunning = 1;
+
+    return ERR_OK;
+}
+
+/**
+ * Wait until a worker finishes every job and release it.
+ *
+ * @param  [ in]pWorker The worker
+ */
+static void _stopWorker(batchWorker *pWorker) {
+    if (pWorker->isRunning) {
+#if defined(__WIN32) || defined(__WIN32__)
+        WaitForSingleObject(pWorker->hThread, INFINITE);
+        CloseHandle(pWorker->hThread);
+#else
+        pthread_join(pWorker->thread, 0);
+#endif
+        pWorker->isRunning = 0;
+    }
+    if (pWorker->pCtx) {
+        gfm_free(&pWorker->pCtx);
+    }
+    pWorker->pCamera = 0;
+}
+
+/**
+ * Report how every job went.
+ *
+ * @param  [ in]wallUs Time spent running every job, in microseconds
+ * @return             How many jobs failed (or diverged)
+ */
+static int _report(uint64_t wallUs) {
+    uint64_t cpuUs;
+    int i, failed, diverged;
+
+    cpuUs = 0;
+    failed = 0;
+    diverged = 0;
+    for (i = 0; i < batch.count; i++) {
+        batchJob *pJob = &batch.pJobs[i];
+        uint64_t avg = 0;
+
+        if (pJob->frames > 0) {
+            avg = pJob->totalUs / pJob->frames;
+        }
+        cpuUs += pJob->totalUs;
+
+        if (pJob->result != ERR_OK) {
+            LOG("FAILED   %s %s: error %i on frame %u\n", pJob->pLevel
+                    , pJob->pReplay, (int)pJob->result
+                    , (unsigned)pJob->frames);
+            failed++;
+            continue;
+        }
+        else if (pJob->divergedAt != -1) {
+            LOG("DIVERGED %s %s: on frame %i of %u", pJob->pLevel
+                    , pJob->pReplay, (int)pJob->divergedAt
+                    , (unsigned)pJob->frames);
+            diverged++;
+        }
+        else {
+            LOG("PASSED   %s %s: %u frames", pJob->pLevel, pJob->pReplay
+                    , (unsigned)pJob->frames);
+        }
+        LOG(", hash %08x, %uus/%uus per frame (avg/max)\n"
+                , (unsigned)pJob->hash, (unsigned)avg
+                , (unsigned)pJob->maxUs);
+    }
+
+    LOG("%i jobs on %i workers: %i passed, %i diverged, %i failed\n"
+            , batch.count, batch.workers, batch.count - diverged - failed
+            , diverged, failed);
+    LOG("Simulated for %ums in %ums (wall-clock)\n"
+            , (unsigned)(cpuUs / 1000), (unsigned)(wallUs / 1000));
+
+    return failed + diverged;
+}
+
+/**
+ * Run every job and report the results.
+ *
+ * @return ERR_OK if every job replayed its recording without diverging,
+ *         ERR_BATCHFAILED otherwise
+ */
+err runBatch() {
+    uint64_t start;
+    err erv;
+    int i;
+
+    ASSERT(batch.pJobs != 0, ERR_ARGUMENTBAD);
+
+    /* Every simulation runs with the main thread's settings (e.g., whether the
+     * characters are controlled synchronously) */
+    batch.flags = (game.flags & ~CMD_BATCH) | CMD_HEADLESS;
+    batch.next = 0;
+
+    for (i = 0; i < batch.workers; i++) {
+        erv = _initWorker(&batch.pWorkers[i]);
+        ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    }
+
+    start = clockGetUs();
+    for (i = 0; i < batch.workers; i++) {
+        erv = _startWorker(&batch.pWorkers[i]);
+        ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    }
+    for (i = 0; i < batch.workers; i++) {
+        _stopWorker(&batch.pWorkers[i]);
+    }
+
+    if (_report(clockGetUs() - start) == 0) {
+        erv = ERR_OK;
+    }
+    else {
+        erv = ERR_BATCHFAILED;
+    }
+__ret:
+    /* On failure, let the started workers finish before releasing them */
+    for (i = 0; i < batch.workers; i++) {
+        _stopWorker(&batch.pWorkers[i]);
+    }
+
+    return erv;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file src/base/clock.c
+ *
+ * Monotonic, high resolution clock used to measure how long each part of a
+ * frame takes. Also implements a sleep that doesn't depend on the game's timer.
+ */
+#include <base/clock.h>
+
+#include <stdint.h>
+
+#if defined(__WIN32) || defined(__WIN32__)
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+/** Retrieve the current time, in microseconds, since an unspecified point */
+uint64_t clockGetUs() {
+#if defined(__WIN32) || defined(__WIN32__)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+
+    if (freq.QuadPart == 0) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&now);
+
+    return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000
+            + (uint64_t)(now.QuadPart % freq.QuadPart) * 1000000
+            / freq.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * Block the current thread for (about) the requested time.
+ *
+ * @param  [ in]us Time to sleep, in microseconds
+ */
+void clockSleepUs(uint64_t us) {
+#if defined(__WIN32) || defined(__WIN32__)
+    /* Windows' sleep only has millisecond granularity, so round it down and
+     * let the caller's margin absorb the difference */
+    if (us >= 1000) {
+        Sleep((DWORD)(us / 1000));
+    }
+#else
+    struct timespec req, rem;
+
+    req.tv_sec = us / 1000000;
+    req.tv_nsec = (us % 1000000) * 1000;
+    /* Resume sleeping if interrupted by a signal */
+    while (nanosleep(&req, &rem) != 0) {
+        req = rem;
+    }
+#endif
+}
+
@@ -9,6 +9,7 @@
  *  -x | --pixel-resolution: Set the initial upcaling factor
  *  -r | --resolution: Set the fullscreen resolution
  *  -F | --FPS: Set the game's initial (and maximum) FPS
+ *  -m | --max-frameskip: Set how many draws may be skipped in a row (0 disables)
  *  -a | --audio: *TODO* Set the audio quality
  *  -v | --vsync: Enable VSync
  *  -f | --fullscreen: Init game in fullscreen mode
@@ -17,9 +18,17 @@
  *  -c | --syncctr: Set character control as synchronous (i.e., move a single character at a time)
  *  -k | --keymap: Remap all keys to the specified configuration
  *  -s | --simpledraw: Slightly speed up drawing on some parts
+ *  -N | --netplay: Play over a loopback transport with the specified latency
+ *  -L | --loss: Chance of losing a packet on the loopback transport
+ *  -B | --batch: Replay every job on the specified list headless and exit
+ *  -W | --workers: Set how many threads are used by the batch runner
+ *  -X | --bot: Step the specified level from commands on the standard input
 #endif JJATENGINE
  *  -S | --save: *TODO* Save the current configuration
  *  -z | --lazy-load: Ignore if songs hasn't finished loading
+ *  -t | --trace: Record a trace of the game's events into the specified file
+ *  -R | --record: Record the input (and the game's state) into the specified file
+ *  -p | --replay: Replay a recording, reporting when the game's state diverges
  */
 #include <base/cmdParse.h>
 #include <base/error.h>
@@ -39,6 +48,8 @@ static void usage() {
     LOG("  -b | --backend: Set the video backend {OpenGL, SDL, Software}\n");
     LOG("  -x | --pixel-resolution: Set the initial upcaling factor\n");
     LOG("  -F | --FPS: Set the game's initial (and maximum) FPS\n");
+    LOG("  -m | --max-frameskip: Set how many draws may be skipped in a row\n"
+            "                        (0 disables skipping draws)\n");
     LOG("  -r | --resolution: Set which resolution is to be used on fullscreen "
             "mode\n");
     LOG("  -a | --audio: Set the audio quality (off, low, med, high, "
@@ -51,9 +62,27 @@ static void usage() {
             "                  (i.e., move a single character at a time)\n");
     LOG("  -k | --keymap: Remap all keys to the specified configuration\n");
     LOG("  -s | --simpledraw: Slightly speed up drawing on some parts\n");
+    LOG("  -N | --netplay: Play over a loopback transport with the specified\n"
+            "                  latency (in milliseconds); gunny's buttons\n"
+            "                  emulate the remote player\n");
+    LOG("  -L | --loss: Chance (in percent) of losing a packet on the\n"
+            "               loopback transport\n");
+    LOG("  -B | --batch: Replay every job on the specified list (one\n"
+            "                \"<level> <recording>\" per line) headless, in\n"
+            "                parallel, report the results and exit\n");
+    LOG("  -W | --workers: Set how many threads are used by the batch runner\n"
+            "                  (0 uses one for each core)\n");
+    LOG("  -X | --bot: Load the specified level and step it from commands read\n"
+            "              from the standard input (see include/jjat2/bot.h)\n");
 #endif /* JJATENGINE */
     LOG("  -S | --save: *TODO* Save the current configuration\n");
     LOG("  -z | --lazy-load: Ignore if songs hasn't finished loading\n");
+    LOG("  -t | --trace: Record a trace of the game's events into the specified\n"
+            "                file (Chrome's trace-event format)\n");
+    LOG("  -R | --record: Record the input (and the game's state) into the\n"
+            "                 specified file\n");
+    LOG("  -p | --replay: Replay a recording, reporting the first frame where\n"
+            "                 the game's state diverges\n");
     LOG("  -h | --help: Print usage\n");
 }
 
@@ -149,6 +178,11 @@ err cmdParse(configCtx *pConfig, int argc, char *argv[]) {
 
             GET_NUM(pConfig->fpsQuality);
         }
+        IS_FLAG("--max-frameskip", "-m") {
+            CHECK_PARAM();
+
+            GET_NUM(pConfig->maxFrameskip);
+        }
         IS_FLAG("--resolution", "-r") {
             CHECK_PARAM();
 
@@ -194,6 +228,31 @@ err cmdParse(configCtx *pConfig, int argc, char *argv[]) {
         IS_FLAG("--simpledraw ", "-s") {
             pConfig->flags |= CFG_SIMPLEDRAW;
         }
+        IS_FLAG("--netplay", "-N") {
+            CHECK_PARAM();
+
+            GET_NUM(pConfig->netplayLatency);
+        }
+        IS_FLAG("--loss", "-L") {
+            CHECK_PARAM();
+
+            GET_NUM(pConfig->netplayLoss);
+        }
+        IS_FLAG("--batch", "-B") {
+            CHECK_PARAM();
+
+            pConfig->pBatchFile = GET_PARAM();
+        }
+        IS_FLAG("--workers", "-W") {
+            CHECK_PARAM();
+
+            GET_NUM(pConfig->batchWorkers);
+        }
+        IS_FLAG("--bot", "-X") {
+            CHECK_PARAM();
+
+            pConfig->pBotLevel = GET_PARAM();
+        }
 #endif /* JJATENGINE */
         IS_FLAG("--save", "-S") {
             doSave = 1;
@@ -222,6 +281,21 @@ err cmdParse(configCtx *pConfig, int argc, char *argv[]) {
         IS_FLAG("--lazy-load", "-z") {
             pConfig->flags |= CFG_LAZYLOAD;
         }
+        IS_FLAG("--trace", "-t") {
+            CHECK_PARAM();
+
+            pConfig->pTraceFile = GET_PARAM();
+        }
+        IS_FLAG("--record", "-R") {
+            CHECK_PARAM();
+
+            pConfig->pRecordFile = GET_PARAM();
+        }
+        IS_FLAG("--replay", "-p") {
+            CHECK_PARAM();
+
+            pConfig->pReplayFile = GET_PARAM();
+        }
         IS_FLAG("--help", "-h") {
             usage();
 
@@ -0,0 +1,216 @@
+/**
+ * @file src/base/framepacer.c
+ *
+ * Governor that adapts the draw rate to how long updates and draws take.
+ */
+#include <base/clock.h>
+#include <base/error.h>
+#include <base/framepacer.h>
+#include <base/game.h>
+
+#include <GFraMe/gfmDebug.h>
+#include <GFraMe/gfmError.h>
+#include <GFraMe/gframe.h>
+
+#include <stdint.h>
+
+/** Weight of new samples on the smoothed costs (as 1 / 2^FP_SMOOTH_SHIFT) */
+#define FP_SMOOTH_SHIFT     3
+/** For how many draws a lower ratio must be viable before it's used */
+#define FP_SETTLE_FRAMES    30
+/** Fraction of the budget kept as headroom when lowering the ratio (1/x) */
+#define FP_HEADROOM_DIV     10
+/** Minimum slack required to go to sleep, in microseconds */
+#define FP_MIN_SLEEP_US     2000
+/** How early the game wakes up, to account for the OS's scheduler */
+#define FP_SLEEP_MARGIN_US  1000
+/** Maximum number of idle draws skipped in a row */
+#define FP_MAX_IDLE_DRAWS   30
+
+/** Update a smoothed cost with a new sample */
+#define SMOOTH(cost, sample) \
+  do { \
+    (cost) += ((int)(sample) - (cost)) >> FP_SMOOTH_SHIFT; \
+  } while (0)
+
+/**
+ * Initialize the frame pacer. Must be called after the FPS is configured.
+ *
+ * @param  [ in]fps          Number of updates executed each second
+ * @param  [ in]maxFrameskip Maximum number of draws skipped in a row (0 disable
+ *                           skipping draws)
+ * @param  [ in]doSleep      Whether the game should sleep when there's slack
+ */
+err initFramePacer(int fps, int maxFrameskip, int doSleep) {
+    ASSERT(fps > 0, ERR_ARGUMENTBAD);
+    ASSERT(maxFrameskip >= 0, ERR_ARGUMENTBAD);
+
+    pacer.fps = fps;
+    pacer.budget = 1000000 / fps;
+    pacer.maxFrameskip = maxFrameskip;
+    pacer.updatesPerDraw = 1;
+    pacer.flags = FP_DIRTY;
+    if (maxFrameskip > 0) {
+        pacer.flags |= FP_SKIP_DRAWS;
+    }
+    if (doSleep) {
+        pacer.flags |= FP_SLEEP;
+    }
+
+    return ERR_OK;
+}
+
+/** Mark the start of an update */
+void framePacerBeginUpdate() {
+    pacer.updateStart = clockGetUs();
+}
+
+/** Mark the end of an update */
+void framePacerEndUpdate() {
+    pacer.lastUpdate = (int)(clockGetUs() - pacer.updateStart);
+    SMOOTH(pacer.updateCost, pacer.lastUpdate);
+    pacer.updateCount++;
+}
+
+/** Mark the start of a draw */
+void framePacerBeginDraw() {
+    pacer.drawStart = clockGetUs();
+}
+
+/**
+ * Calculate how many updates must be executed for each draw, so the frames fit
+ * within the budget.
+ *
+ * Running N updates and a draw must take at most N frames, therefore:
+ *   N * updateCost + drawCost <= N * budget
+ *
+ * @param  [ in]budget Time available for each update, in microseconds
+ */
+static int _getUpdatesPerDraw(int budget) {
+    int avail, num;
+
+    avail = budget - pacer.updateCost;
+    if (avail <= 0) {
+        /* Updating alone can't keep up, so draw as little as possible */
+        return pacer.maxFrameskip + 1;
+    }
+
+    num = (pacer.drawCost + avail - 1) / avail;
+    if (num < 1) {
+        num = 1;
+    }
+    else if (num > pacer.maxFrameskip + 1) {
+        num = pacer.maxFrameskip + 1;
+    }
+
+    return num;
+}
+
+/**
+ * Mark the end of a draw and, if required, adjust the draw rate based on the
+ * current costs.
+ */
+err framePacerEndDraw() {
+    int num;
+
+    pacer.lastDraw = (int)(clockGetUs() - pacer.drawStart);
+    SMOOTH(pacer.drawCost, pacer.lastDraw);
+    if (pacer.updateCount > 1) {
+        pacer.skippedDraws += pacer.updateCount - 1;
+    }
+    pacer.updateCount = 0;
+
+    if (!(pacer.flags & FP_SKIP_DRAWS)) {
+        return ERR_OK;
+    }
+
+    num = _getUpdatesPerDraw(pacer.budget);
+    if (num > pacer.updatesPerDraw) {
+        /* Falling behind, skip draws right away */
+        pacer.settle = 0;
+    }
+    else {
+        /* Only draw more often after it has been viable (with some headroom)
+         * for a while, to avoid oscillating around the threshold */
+        num = _getUpdatesPerDraw(pacer.budget
+                - pacer.budget / FP_HEADROOM_DIV);
+        if (num < pacer.updatesPerDraw) {
+            pacer.settle++;
+        }
+        else {
+            pacer.settle = 0;
+        }
+
+        if (pacer.settle < FP_SETTLE_FRAMES) {
+            return ERR_OK;
+        }
+        pacer.settle = 0;
+    }
+
+    if (num != pacer.updatesPerDraw) {
+        gfmRV rv;
+
+        rv = gfm_setStateFrameRate(game.pCtx, pacer.fps, pacer.fps / num);
+        ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+        pacer.updatesPerDraw = num;
+    }
+
+    return ERR_OK;
+}
+
+/** Signal that something changed on screen and the next draw must happen */
+void markFrameDirty() {
+    pacer.flags |= FP_DIRTY;
+}
+
+/**
+ * Check whether the next draw should actually be rendered. If nothing changed
+ * since the last one, it's skipped (unless too many were skipped in a row, to
+ * refresh the window every now and then).
+ *
+ * @return 1 if the frame should be drawn, 0 otherwise
+ */
+int framePacerShouldDraw() {
+    if ((pacer.flags & FP_DIRTY) || pacer.idleDraws >= FP_MAX_IDLE_DRAWS) {
+        pacer.flags &= ~FP_DIRTY;
+        pacer.idleDraws = 0;
+        return 1;
+    }
+
+    pacer.idleDraws++;
+    pacer.idleSkipped++;
+    /* Idle frames aren't skipped due to their cost, so don't account them */
+    pacer.updateCount = 0;
+    return 0;
+}
+
+/**
+ * If there's enough time before the next update, sleep until right before it.
+ * Should be called before waiting for events.
+ */
+void framePacerSleep() {
+    uint64_t now, deadline;
+
+    pacer.sleptUs = 0;
+    if (!(pacer.flags & FP_SLEEP) || pacer.updateStart == 0) {
+        return;
+    }
+
+    now = clockGetUs();
+    deadline = pacer.updateStart + pacer.budget;
+    if (now + FP_MIN_SLEEP_US > deadline) {
+        return;
+    }
+
+    pacer.sleptUs = (int)(deadline - now - FP_SLEEP_MARGIN_US);
+    clockSleepUs(pacer.sleptUs);
+}
+
+/** Render the governor's current state (for debugging) */
+void drawFramePacerInfo() {
+    gfmDebug_printf(game.pCtx, 0, 80, "UPDATE : %ius\nDRAW   : %ius\n"
+            "UPD/DRW: %i\nSKIPPED: %i\nIDLE   : %i\nSLEPT  : %ius"
+            , pacer.updateCost, pacer.drawCost, pacer.updatesPerDraw
+            , pacer.skippedDraws, pacer.idleSkipped, pacer.sleptUs);
+}
+
@@ -3,8 +3,11 @@
  */
 #include <base/collision.h>
 #include <base/error.h>
+#include <base/framepacer.h>
 #include <base/game.h>
 #include <base/input.h>
+#include <base/perfoverlay.h>
+#include <base/trace.h>
 #include <conf/input_list.h>
 
 #include <GFraMe/gfmError.h>
@@ -99,9 +102,19 @@ void handleDebugInput() {
         game.debugRunState = DBG_STEP;
     }
 
+    if (DID_JUST_RELEASE(dbgPerf)) {
+        togglePerfOverlay();
+    }
+
+    if (DID_JUST_RELEASE(dbgTrace)) {
+        /* Failing to record a trace shouldn't stop the game */
+        toggleTrace();
+    }
+
     if (DID_JUST_RELEASE(qt)) {
         /* Toggle quadtree visibility */
         collision.flags ^= CF_VISIBLE;
+        markFrameDirty();
     }
 
     if (DID_JUST_RELEASE(gif)) {
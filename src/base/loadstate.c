@@ -77,6 +77,8 @@ void freeLoadstate() {
  */
 void startLoadstate() {
     if (!((game.flags & CMD_LAZYLOAD) && isPastSfx())) {
+        /* Progress restarts on every batch, so force the name to be updated */
+        loadstate.lastProgress = -1;
         loadstate.lastState = game.currentState;
         game.currentState = ST_LOADSTATE;
     }
@@ -89,8 +91,7 @@ void checkStopLoadstate() {
     int lazy;
 
     lazy = (game.flags & CMD_LAZYLOAD) && isPastSfx();
-    if (game.currentState == ST_LOADSTATE && (lazy
-            || res.loader.progress >= res.loader.numLoading)) {
+    if (game.currentState == ST_LOADSTATE && (lazy || !isLoading())) {
         game.currentState = loadstate.lastState;
     }
 }
@@ -103,8 +104,7 @@ err updateLoadstate() {
     if (loadstate.pBitmapFont == 0) {
         return ERR_OK;
     }
-    else if (((game.flags & CMD_LAZYLOAD) && isPastSfx()) ||
-            res.loader.progress >= res.loader.numLoading) {
+    else if (((game.flags & CMD_LAZYLOAD) && isPastSfx()) || !isLoading()) {
         return ERR_OK;
     }
 
@@ -114,10 +114,6 @@ err updateLoadstate() {
         int len;
 
         loadstate.lastProgress = res.loader.progress;
-        if (loadstate.lastProgress == res.loader.numLoading) {
-            /* progress was updated by the other thread, bail out */
-            return ERR_OK;
-        }
         pText = getCurrentResourceName();
         len = strlen(pText);
 
@@ -154,8 +150,7 @@ err drawLoadstate() {
     if (loadstate.pBitmapFont == 0) {
         return ERR_OK;
     }
-    else if (((game.flags & CMD_LAZYLOAD) && isPastSfx()) ||
-            res.loader.progress >= res.loader.numLoading) {
+    else if (((game.flags & CMD_LAZYLOAD) && isPastSfx()) || !isLoading()) {
         return ERR_OK;
     }
 
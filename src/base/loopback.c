@@ -0,0 +1,113 @@
+/**
+ * @file src/base/loopback.c
+ *
+ * A local stand-in for a network transport, with artificial latency and loss.
+ */
+#include <base/error.h>
+#include <base/loopback.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Seed used whenever the transport is configured */
+#define LOOPBACK_SEED   0x6a6a6174
+
+/** Retrieve the next random number (xorshift32) */
+static uint32_t _random() {
+    uint32_t x = loopback.seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    loopback.seed = x;
+
+    return x;
+}
+
+/**
+ * Configure the transport, dropping any packet in flight.
+ *
+ * @param  [ in]latency Delay until a packet may be received, in milliseconds
+ * @param  [ in]loss    Chance of losing a packet, in percent
+ */
+void configureLoopback(int latency, int loss) {
+    memset(&loopback, 0x0, sizeof(loopbackCtx));
+    loopback.seed = LOOPBACK_SEED;
+    loopback.latency = latency;
+    loopback.loss = loss;
+}
+
+/**
+ * Advance the transport's time.
+ *
+ * @param  [ in]elapsed Time since the last update, in milliseconds
+ */
+void updateLoopback(int elapsed) {
+    loopback.time += (uint32_t)elapsed;
+}
+
+/**
+ * Send a packet. Just like a datagram, it's silently dropped if it's lost or if
+ * there are too many packets in flight.
+ *
+ * @param  [ in]channel The channel
+ * @param  [ in]pData   The packet
+ * @param  [ in]len     Length of the packet
+ */
+err loopbackSend(int channel, const void *pData, int len) {
+    loopbackPacket *pPacket;
+    int i;
+
+    ASSERT(channel >= 0 && channel < LOOPBACK_CHANNELS, ERR_ARGUMENTBAD);
+    ASSERT(len > 0 && len <= LOOPBACK_MAX_PACKET_LEN, ERR_BUFFERTOOSMALL);
+
+    if ((int)(_random() % 100) < loopback.loss
+            || loopback.pCount[channel] == LOOPBACK_MAX_PACKETS) {
+        return ERR_OK;
+    }
+
+    i = (loopback.pHead[channel] + loopback.pCount[channel])
+            % LOOPBACK_MAX_PACKETS;
+    pPacket = &loopback.pPackets[channel][i];
+    pPacket->deliverAt = loopback.time + (uint32_t)loopback.latency;
+    pPacket->len = (uint16_t)len;
+    memcpy(pPacket->pData, pData, len);
+    loopback.pCount[channel]++;
+
+    return ERR_OK;
+}
+
+/**
+ * Receive the oldest packet that already arrived.
+ *
+ * @param  [ in]channel The channel
+ * @param  [out]pData   The packet
+ * @param  [ in]maxLen  How many bytes fit on pData
+ * @return              Length of the packet, or 0 if none arrived
+ */
+int loopbackReceive(int channel, void *pData, int maxLen) {
+    loopbackPacket *pPacket;
+    int len;
+
+    if (channel < 0 || channel >= LOOPBACK_CHANNELS
+            || loopback.pCount[channel] == 0) {
+        return 0;
+    }
+
+    /* Since the latency is constant, packets arrive in order */
+    pPacket = &loopback.pPackets[channel][loopback.pHead[channel]];
+    if (pPacket->deliverAt > loopback.time) {
+        return 0;
+    }
+
+    len = pPacket->len;
+    if (len > maxLen) {
+        len = maxLen;
+    }
+    memcpy(pData, pPacket->pData, len);
+    loopback.pHead[channel] = (loopback.pHead[channel] + 1)
+            % LOOPBACK_MAX_PACKETS;
+    loopback.pCount[channel]--;
+
+    return len;
+}
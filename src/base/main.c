@@ -1,16 +1,23 @@
 /**
  * @file src/main.c
  */
+#include <base/batch.h>
 #include <base/collision.h>
 #include <base/game.h>
 #include <base/gfx.h>
 #include <base/input.h>
 #include <base/loadstate.h>
 #include <base/mainloop.h>
+#include <base/replay.h>
 #include <base/resource.h>
 #include <base/setup.h>
 #include <base/sfx.h>
 #include <base/static.h>
+#include <base/trace.h>
+
+#if defined(JJATENGINE)
+#  include <jjat2/bot.h>
+#endif /* JJATENGINE */
 
 /**
  * Entry point. Setup everything and handle cleaning up the game, when it exits
@@ -32,6 +39,19 @@ int main(int argc, char *argv[]) {
 
     erv = initGfx();
     ASSERT_TO(erv == ERR_OK, erv = erv, __ret);
+
+#if defined(JJATENGINE)
+    /* The batch runner and the bot only need the spritesets */
+    if (game.flags & CMD_BATCH) {
+        erv = runBatch();
+        goto __ret;
+    }
+    else if (game.flags & CMD_BOT) {
+        erv = runBotCli(game.pBotLevel);
+        goto __ret;
+    }
+#endif /* JJATENGINE */
+
     erv = initSfx();
     ASSERT_TO(erv == ERR_OK, erv = erv, __ret);
     erv = initResource();
@@ -52,6 +72,9 @@ int main(int argc, char *argv[]) {
 
     erv = mainloop();
 __ret:
+    freeBatch();
+    stopReplay();
+    stopTrace();
     cleanResource();
     cleanCollision();
     freeLoadstate();
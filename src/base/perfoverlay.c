@@ -0,0 +1,125 @@
+/**
+ * @file src/base/perfoverlay.c
+ *
+ * In-game performance overlay.
+ */
+#include <base/collision.h>
+#include <base/framepacer.h>
+#include <base/game.h>
+#include <base/perfoverlay.h>
+#include <base/resource.h>
+
+#include <conf/game.h>
+
+#include <GFraMe/gfmDebug.h>
+
+#include <stdio.h>
+
+/** Width of the update/draw bars, in characters (matching a frame's budget) */
+#define PERF_BAR_WIDTH  10
+/** Width of the overlay, in characters */
+#define PERF_COLUMNS    (PERF_HISTORY + 1)
+/** Size of the buffer where the overlay is rendered */
+#define PERF_BUF_LEN    1024
+
+/** Show/hide the overlay */
+void togglePerfOverlay() {
+    perf.visible = !perf.visible;
+    markFrameDirty();
+}
+
+/** Sample the update that just finished. Must be called after
+ * framePacerEndUpdate */
+void perfOverlayEndUpdate() {
+    perf.head = (perf.head + 1) % PERF_HISTORY;
+    perf.pFrameUs[perf.head] = pacer.lastUpdate;
+    perf.updateUs = pacer.lastUpdate;
+
+    perf.collisionPairs = collision.pairs;
+    collision.pairs = 0;
+
+    if (perf.visible) {
+        /* The overlay changes every frame */
+        markFrameDirty();
+    }
+}
+
+/** Sample the draw that just finished. Must be called after
+ * framePacerEndDraw */
+void perfOverlayEndDraw() {
+    perf.pFrameUs[perf.head] += pacer.lastDraw;
+    perf.drawUs = pacer.lastDraw;
+}
+
+/**
+ * Render a bar proportional to a cost, where the full bar is the frame's
+ * budget. Costs over the budget are marked by a '>'.
+ *
+ * @param  [ in]pBuf  Where the bar is rendered
+ * @param  [ in]pName Label of the bar
+ * @param  [ in]us    The cost, in microseconds
+ * @return            Number of characters written
+ */
+static int _renderBar(char *pBuf, char *pName, int us) {
+    int i, len, num;
+
+    num = us * PERF_BAR_WIDTH / pacer.budget;
+    len = sprintf(pBuf, "%-4s", pName);
+    for (i = 0; i < PERF_BAR_WIDTH; i++) {
+        pBuf[len++] = (i < num) ? '#' : '.';
+    }
+    pBuf[len++] = (num > PERF_BAR_WIDTH) ? '>' : ' ';
+    len += sprintf(pBuf + len, "%6i\n", us);
+
+    return len;
+}
+
+/**
+ * Render the overlay, if visible.
+ *
+ * @param  [ in]pList Game specific counters
+ * @param  [ in]len   Number of counters in pList
+ */
+void drawPerfOverlay(perfCounter *pList, int len) {
+    char pBuf[PERF_BUF_LEN];
+    int i, pos, row, max;
+
+    if (!perf.visible || pacer.budget == 0) {
+        return;
+    }
+
+    /* The graph's top is twice the budget, so the middle line is the budget */
+    max = pacer.budget * 2;
+    pos = sprintf(pBuf, "FRAME (TOP %ius)\n", max);
+    for (row = PERF_GRAPH_ROWS; row > 0; row--) {
+        int threshold = max * row / PERF_GRAPH_ROWS;
+
+        for (i = 1; i <= PERF_HISTORY; i++) {
+            int us = perf.pFrameUs[(perf.head + i) % PERF_HISTORY];
+
+            if (us >= threshold) {
+                pBuf[pos++] = '|';
+            }
+            else if (threshold == pacer.budget) {
+                pBuf[pos++] = '-';
+            }
+            else {
+                pBuf[pos++] = ' ';
+            }
+        }
+        pBuf[pos++] = '\n';
+    }
+
+    pos += _renderBar(pBuf + pos, "UPD", perf.updateUs);
+    pos += _renderBar(pBuf + pos, "DRW", perf.drawUs);
+
+    for (i = 0; i < len && pos < PERF_BUF_LEN - PERF_COLUMNS * 3; i++) {
+        pos += sprintf(pBuf + pos, "%-5s %4i/%-4i\n", pList[i].pName
+                , pList[i].value, pList[i].cap);
+    }
+    pos += sprintf(pBuf + pos, "PAIRS %4i\nLOAD  %4i+%i\n"
+            , perf.collisionPairs, getLoaderQueueLength()
+            , res.loader.numInFlight);
+
+    gfmDebug_printf(game.pCtx, V_WIDTH - PERF_COLUMNS * 8, 0, "%s", pBuf);
+}
@@ -0,0 +1,252 @@
+/**
+ * @file src/base/replay.c
+ *
+ * Record the input of every simulated frame and replay it later.
+ *
+ * A recording starts with a header ("JJRP", the format's version and the
+ * number of recorded buttons) followed by every frame:
+ *   - the frame's elapsed time (16 bits);
+ *   - the state and press count of every button (8 bits each);
+ *   - the simulation's hash after the frame (32 bits).
+ * Every value is stored as little-endian.
+ */
+#include <base/error.h>
+#include <base/game.h>
+#include <base/input.h>
+#include <base/replay.h>
+#include <conf/input_list.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG(...) printf(__VA_ARGS__)
+
+/** Identifies a recording */
+#define REPLAY_MAGIC    "JJRP"
+/** Version of the recording's format */
+#define REPLAY_VERSION  1
+
+/** Number of buttons recorded (every non-debug button) */
+enum {
+#define X_GPAD(...)
+#define X_KEY(...) + 1
+    REPLAY_BUTTONS = 0
+    X_RELEASE_BUTTON_LIST
+    X_SYSTEM_BUTTON_LIST
+#undef X_KEY
+#undef X_GPAD
+};
+
+/**
+ * Write a little-endian value into the recording.
+ *
+ * @param  [ in]val The value
+ * @param  [ in]len Size of the value, in bytes
+ */
+static err _writeVal(uint32_t val, int len) {
+    uint8_t pBuf[4];
+    int i;
+
+    for (i = 0; i < len; i++) {
+        pBuf[i] = (val >> (i * 8)) & 0xff;
+    }
+    ASSERT(fwrite(pBuf, 1, len, replay.pFile) == (size_t)len, ERR_OPENFILE);
+
+    return ERR_OK;
+}
+
+/**
+ * Read a little-endian value from the recording.
+ *
+ * @param  [out]pVal The value
+ * @param  [ in]len  Size of the value, in bytes
+ * @return           ERR_OK, or ERR_INDEXOOB if the recording is over
+ */
+static err _readVal(uint32_t *pVal, int len) {
+    uint8_t pBuf[4];
+    int i;
+
+    if (fread(pBuf, 1, len, replay.pFile) != (size_t)len) {
+        return ERR_INDEXOOB;
+    }
+
+    *pVal = 0;
+    for (i = 0; i < len; i++) {
+        *pVal |= (uint32_t)pBuf[i] << (i * 8);
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Check whether the current frame is part of the simulation (and should,
+ * therefore, be recorded/replayed).
+ */
+static int _isSimulating() {
+    return replay.mode != RM_NONE && game.currentState != ST_LOADSTATE;
+}
+
+/**
+ * Start recording the input.
+ *
+ * @param  [ in]pPath Where the recording should be written
+ */
+err startRecording(char *pPath) {
+    err erv;
+
+    ASSERT(pPath != 0, ERR_ARGUMENTBAD);
+    ASSERT(replay.mode == RM_NONE, ERR_ARGUMENTBAD);
+
+    replay.pFile = fopen(pPath, "wb");
+    ASSERT(replay.pFile != 0, ERR_OPENFILE);
+    replay.frame = 0;
+    replay.divergedAt = -1;
+    replay.mode = RM_RECORD;
+
+    ASSERT(fwrite(REPLAY_MAGIC, 1, sizeof(REPLAY_MAGIC) - 1, replay.pFile)
+            == sizeof(REPLAY_MAGIC) - 1, ERR_OPENFILE);
+    erv = _writeVal(REPLAY_VERSION, 1);
+    ASSERT(erv == ERR_OK, erv);
+    erv = _writeVal(REPLAY_BUTTONS, 1);
+    ASSERT(erv == ERR_OK, erv);
+
+    return ERR_OK;
+}
+
+/**
+ * Start replaying a previous recording. The game's input is ignored until it
+ * finishes.
+ *
+ * @param  [ in]pPath The recording
+ */
+err startReplay(char *pPath) {
+    char pMagic[sizeof(REPLAY_MAGIC) - 1];
+    uint32_t val;
+    err erv;
+
+    ASSERT(pPath != 0, ERR_ARGUMENTBAD);
+    ASSERT(replay.mode == RM_NONE, ERR_ARGUMENTBAD);
+
+    replay.pFile = fopen(pPath, "rb");
+    ASSERT(replay.pFile != 0, ERR_OPENFILE);
+    replay.frame = 0;
+    replay.divergedAt = -1;
+    replay.mode = RM_PLAY;
+
+    ASSERT(fread(pMagic, 1, sizeof(pMagic), replay.pFile) == sizeof(pMagic)
+            && memcmp(pMagic, REPLAY_MAGIC, sizeof(pMagic)) == 0
+            , ERR_PARSINGERR);
+    erv = _readVal(&val, 1);
+    ASSERT(erv == ERR_OK && val == REPLAY_VERSION, ERR_PARSINGERR);
+    erv = _readVal(&val, 1);
+    ASSERT(erv == ERR_OK && val == REPLAY_BUTTONS, ERR_PARSINGERR);
+
+    return ERR_OK;
+}
+
+/** Stop recording/replaying, reporting the replay's result (if any) */
+void stopReplay() {
+    if (replay.mode == RM_PLAY && !replay.quiet) {
+        if (replay.divergedAt == -1) {
+            LOG("Replay finished after %u frames: no divergence\n"
+                    , (unsigned)replay.frame);
+        }
+        else {
+            LOG("Replay finished after %u frames: diverged on frame %i\n"
+                    , (unsigned)replay.frame, (int)replay.divergedAt);
+        }
+    }
+
+    if (replay.pFile != 0) {
+        fclose(replay.pFile);
+        replay.pFile = 0;
+    }
+    replay.mode = RM_NONE;
+}
+
+/**
+ * Either record the current frame's input or overwrite it with the recorded
+ * one. Must be called after the input and the elapsed time are retrieved.
+ */
+err replayFrameInput() {
+    button *pButtons;
+    uint32_t val;
+    err erv;
+    int i;
+
+    if (!_isSimulating()) {
+        return ERR_OK;
+    }
+
+    pButtons = (button*)(&input);
+    if (replay.mode == RM_RECORD) {
+        erv = _writeVal((uint32_t)game.elapsed, 2);
+        ASSERT(erv == ERR_OK, erv);
+        for (i = 0; i < REPLAY_BUTTONS; i++) {
+            int num = pButtons[i].numPressed;
+
+            if (num > 0xff) {
+                num = 0xff;
+            }
+            erv = _writeVal((uint32_t)pButtons[i].state, 1);
+            ASSERT(erv == ERR_OK, erv);
+            erv = _writeVal((uint32_t)num, 1);
+            ASSERT(erv == ERR_OK, erv);
+        }
+        return ERR_OK;
+    }
+
+    erv = _readVal(&val, 2);
+    if (erv == ERR_INDEXOOB) {
+        /* Recording is over, give control back to the player */
+        stopReplay();
+        return ERR_OK;
+    }
+    game.elapsed = (int)val;
+    for (i = 0; i < REPLAY_BUTTONS; i++) {
+        erv = _readVal(&val, 1);
+        ASSERT(erv == ERR_OK, ERR_PARSINGERR);
+        pButtons[i].state = (gfmInputState)val;
+        erv = _readVal(&val, 1);
+        ASSERT(erv == ERR_OK, ERR_PARSINGERR);
+        pButtons[i].numPressed = (int)val;
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Either record the simulation's state hash or compare it against the
+ * recorded one. Must be called after the simulation is updated.
+ */
+err replayFrameState() {
+    uint32_t hash, val;
+    err erv;
+
+    if (!_isSimulating()) {
+        return ERR_OK;
+    }
+
+    hash = getSimulationHash();
+    if (replay.mode == RM_RECORD) {
+        erv = _writeVal(hash, 4);
+        ASSERT(erv == ERR_OK, erv);
+    }
+    else {
+        erv = _readVal(&val, 4);
+        ASSERT(erv == ERR_OK, ERR_PARSINGERR);
+
+        if (val != hash && replay.divergedAt == -1) {
+            replay.divergedAt = (int32_t)replay.frame;
+            if (!replay.quiet) {
+                LOG("Replay diverged on frame %u (expected %08x, got %08x)\n"
+                        , (unsigned)replay.frame, (unsigned)val
+                        , (unsigned)hash);
+            }
+        }
+    }
+    replay.frame++;
+
+    return ERR_OK;
+}
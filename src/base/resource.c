@@ -8,14 +8,23 @@
  * initialization), it will most likely be useful during development (so the
  * game won't have to be recompiled to add/test new songs) and for modding.
  */
+#include <base/atomic.h>
+#include <base/clock.h>
 #include <base/game.h>
+#include <base/hash.h>
 #include <base/resource.h>
 #include <base/sfx.h>
+#include <base/trace.h>
 #include <conf/sfx_list.h>
 #include <GFraMe/gframe.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 
+/* Perfect hash table for the songs on SONGS_LIST, generated by
+ * misc/songhash.py */
+#include <auto/songhash.c>
+
 /* Help set the default resource path in a common place */
 #define SFX_BASE_PATH "sfx/"
 #define SONG_BASE_PATH "songs/"
@@ -44,13 +53,296 @@ static char* _pResSrc[] = {
 #undef X
 };
 
+/** Maximum length of a resource's path (including the '\0') */
+#define LOADER_MAX_PATH 128
+
+/** State of a slot on the loader's job list */
+enum enLoaderJobState {
+    JOB_FREE = 0
+  , JOB_QUEUED
+  , JOB_LOADING
+};
+typedef enum enLoaderJobState loaderJobState;
+
+/** A resource waiting to be (or being) loaded. Everything passed to the
+ * loading thread lives in here, so it must not move while loading. */
+struct stLoaderJob {
+    /** Path to the resource */
+    char pPath[LOADER_MAX_PATH];
+    /** Points to pPath, as expected by the loader */
+    char *pFile;
+    /** Points to handle, as expected by the loader */
+    int *pHandle;
+    /** Handle filled by the loading thread */
+    int handle;
+    /** Number of loaded resources (i.e., 1 when done). Written by GFraMe's
+     * loading thread with a plain store and polled every frame, since GFraMe
+     * doesn't signal when an asset finishes loading */
+    int progress;
+    /** Index of the resource (sound effects first and then songs) */
+    int dst;
+    /** Sequence number, to keep the queue's order within a priority */
+    int seq;
+    /** Position of the job within the queue's heap */
+    int heapPos;
+    /** Offset to the resource's name within pPath */
+    int nameOffset;
+    /** When the resource started loading (0 if not tracing) */
+    uint64_t traceStart;
+    resourcePriority priority;
+    loaderJobState state;
+    gfmAssetType type;
+};
+typedef struct stLoaderJob loaderJob;
+
 /* Static list of song handles */
 static int _songHandleList[SNG_MAX];
-/** List of handles though which the loaded resources will be accessed (actually
- * filled on initResource) */
-static int* _pResHnd[SFX_MAX + SNG_MAX];
-/** List of types for the loaded resources (initialized on initResource) */
-static gfmAssetType _pResType[SFX_MAX + SNG_MAX];
+/** List of handles though which the loaded sound effects will be accessed
+ * (actually filled on initResource) */
+static int* _pResHnd[SFX_MAX + 1];
+/** Every resource either queued or loading */
+static loaderJob _jobs[LOADER_MAX_JOBS];
+/** Priority queue (a binary max-heap of indexes into _jobs) */
+static int _queue[LOADER_MAX_JOBS];
+/** Number of resources on the queue */
+static int _queueLen;
+
+/** Ring of resources that finished loading (the completion list). Both ends run
+ * on the main thread: updateResourceLoader appends a resource once it notices
+ * that its job is done and playPendingSong drains them. Its length must be a
+ * power of two. Since it holds at most one entry per job, it never overflows as
+ * long as it's drained every frame */
+#define COMPLETION_LEN  LOADER_MAX_JOBS
+static resourceCompletion _completions[COMPLETION_LEN];
+/** Next position to be written */
+static unsigned int _completionHead;
+/** Next position to be read */
+static unsigned int _completionTail;
+
+/**
+ * Check whether a job should be loaded before another one.
+ *
+ * @param [ in]a Index of a job
+ * @param [ in]b Index of the other job
+ */
+static int _isJobBefore(int a, int b) {
+    if (_jobs[a].priority != _jobs[b].priority) {
+        return _jobs[a].priority > _jobs[b].priority;
+    }
+    else if (_jobs[a].priority == RES_PRIO_MUSIC) {
+        /* Only the latest requested song is actually needed */
+        return _jobs[a].seq > _jobs[b].seq;
+    }
+    return _jobs[a].seq < _jobs[b].seq;
+}
+
+/** Swap two positions on the queue */
+static void _swapQueue(int i, int j) {
+    int tmp;
+
+    tmp = _queue[i];
+    _queue[i] = _queue[j];
+    _queue[j] = tmp;
+    _jobs[_queue[i]].heapPos = i;
+    _jobs[_queue[j]].heapPos = j;
+}
+
+/** Move a job towards the front of the queue, as long as required */
+static void _siftUp(int pos) {
+    while (pos > 0 && _isJobBefore(_queue[pos], _queue[(pos - 1) / 2])) {
+        _swapQueue(pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+}
+
+/** Move a job towards the back of the queue, as long as required */
+static void _siftDown(int pos) {
+    while (1) {
+        int first, left, right;
+
+        first = pos;
+        left = pos * 2 + 1;
+        right = pos * 2 + 2;
+        if (left < _queueLen && _isJobBefore(_queue[left], _queue[first])) {
+            first = left;
+        }
+        if (right < _queueLen && _isJobBefore(_queue[right], _queue[first])) {
+            first = right;
+        }
+        if (first == pos) {
+            break;
+        }
+        _swapQueue(pos, first);
+        pos = first;
+    }
+}
+
+/** Remove the first job from the queue and return its index */
+static int _popQueue() {
+    int idx;
+
+    idx = _queue[0];
+    _queueLen--;
+    if (_queueLen > 0) {
+        _queue[0] = _queue[_queueLen];
+        _jobs[_queue[0]].heapPos = 0;
+        _siftDown(0);
+    }
+    _jobs[idx].heapPos = -1;
+
+    return idx;
+}
+
+/**
+ * Retrieve the handle of a resource from its index (see loaderJob.dst)
+ *
+ * @param [ in]dst Index of the resource
+ */
+static int* _getResourceHandle(int dst) {
+    if (dst < SFX_MAX) {
+        return _pResHnd[dst];
+    }
+    return res.pHandles + dst - SFX_MAX;
+}
+
+/**
+ * Retrieve the job loading a given resource, if any.
+ *
+ * @param [ in]dst Index of the resource
+ * @return         The job, or NULL if the resource isn't queued
+ */
+static loaderJob* _getJob(int dst) {
+    int i;
+
+    for (i = 0; i < LOADER_MAX_JOBS; i++) {
+        if (_jobs[i].state != JOB_FREE && _jobs[i].dst == dst) {
+            return _jobs + i;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Append a resource that finished loading to the completion list.
+ *
+ * @param [ in]pJob The finished job
+ */
+static err _postCompletion(loaderJob *pJob) {
+    resourceCompletion *pOut;
+    unsigned int head;
+
+    head = _completionHead;
+    ASSERT(head - _completionTail < COMPLETION_LEN, ERR_BUFFERTOOSMALL);
+
+    pOut = _completions + (head & (COMPLETION_LEN - 1));
+    pOut->handle = pJob->handle;
+    if (pJob->dst < SFX_MAX) {
+        pOut->idx = pJob->dst;
+        pOut->isSong = 0;
+    }
+    else {
+        pOut->idx = pJob->dst - SFX_MAX;
+        pOut->isSong = 1;
+    }
+
+    _completionHead = head + 1;
+    return ERR_OK;
+}
+
+/**
+ * Retrieve the next resource that finished loading, in the order they
+ * finished. Every completion is retrieved only once.
+ *
+ * @param  [out]pOut The completion
+ * @return           1 if a completion was retrieved, 0 if none is pending
+ */
+int popResourceCompletion(resourceCompletion *pOut) {
+    unsigned int tail;
+
+    tail = _completionTail;
+    if (tail == _completionHead) {
+        return 0;
+    }
+
+    *pOut = _completions[tail & (COMPLETION_LEN - 1)];
+    _completionTail = tail + 1;
+    return 1;
+}
+
+/**
+ * Queue a resource to be loaded.
+ *
+ * @param [ in]pBase    Base path of the resource
+ * @param [ in]pName    Name of the resource
+ * @param [ in]dst      Index of the resource (see loaderJob.dst)
+ * @param [ in]priority Priority of the resource
+ */
+static err _queueResource(char *pBase, char *pName, int dst
+        , resourcePriority priority) {
+    loaderJob *pJob;
+    int baseLen, i, nameLen;
+
+    for (i = 0; i < LOADER_MAX_JOBS; i++) {
+        if (_jobs[i].state == JOB_FREE) {
+            break;
+        }
+    }
+    ASSERT(i < LOADER_MAX_JOBS, ERR_ALREADYLOADING);
+
+    baseLen = strlen(pBase);
+    nameLen = strlen(pName);
+    ASSERT(baseLen + nameLen < LOADER_MAX_PATH, ERR_BUFFERTOOSMALL);
+
+    pJob = _jobs + i;
+    memcpy(pJob->pPath, pBase, baseLen);
+    memcpy(pJob->pPath + baseLen, pName, nameLen + 1);
+    pJob->pFile = pJob->pPath;
+    pJob->pHandle = &pJob->handle;
+    pJob->handle = -1;
+    pJob->progress = 0;
+    pJob->dst = dst;
+    pJob->seq = res.loader.seq++;
+    pJob->nameOffset = baseLen;
+    pJob->priority = priority;
+    pJob->state = JOB_QUEUED;
+    pJob->type = ASSET_AUDIO;
+
+    *_getResourceHandle(dst) = -1;
+    if (priority == RES_PRIO_SFX) {
+        res.loader.numLoading++;
+        res.loader.numSfx++;
+    }
+
+    pJob->heapPos = _queueLen;
+    _queue[_queueLen] = i;
+    _queueLen++;
+    _siftUp(pJob->heapPos);
+
+    return ERR_OK;
+}
+
+/**
+ * Queue a song to be decoded, if it isn't already. If it's still waiting on the
+ * queue, it's moved ahead of every other song.
+ *
+ * @param [ in]idx   Index of the song
+ * @param [ in]pName Name of the song
+ */
+static err _requestSong(int idx, char *pName) {
+    loaderJob *pJob;
+
+    pJob = _getJob(SFX_MAX + idx);
+    if (pJob == 0) {
+        return _queueResource(SONG_BASE_PATH, pName, SFX_MAX + idx
+                , RES_PRIO_MUSIC);
+    }
+    else if (pJob->state == JOB_QUEUED) {
+        pJob->seq = res.loader.seq++;
+        _siftUp(pJob->heapPos);
+    }
+
+    return ERR_OK;
+}
 
 /**
  * Check whether a handle has already been loaded. If not, ERR_LOADINGRESOURCE
@@ -78,82 +370,78 @@ static char* _getDynSongName(int idx) {
 }
 
 /**
- * Setup everything and start the BG thread loading the resources.
+ * Look for a dynamically loaded song on the hashed index.
  *
- * @param [out]pHandles   List where the loaded handles shall be stored
- * @param [ in]ppFiles    List of files to be loaded
- * @param [ in]numHandles How many handles there are in the list
+ * @param [ in]pName Name of the song
+ * @return           Index of the song, or -1 if not found
  */
-static err startLoadingResources(int *pHandles, char **ppFiles, int numHandles) {
-    gfmAssetType *pResType;
-    gfmRV rv;
-    int i, len;
-
-    /* Check if anything else is currently being loaded */
-    ASSERT(res.loader.progress == -1 ||
-            res.loader.progress == res.loader.numLoading, ERR_ALREADYLOADING);
-
-    /* Expand buffers as necessary */
-    if (res.loader.len < numHandles) {
-        res.loader.len = numHandles;
+static int _findDynSong(char *pName) {
+    uint32_t slot;
 
-        res.loader.ppHandles = realloc(res.loader.ppHandles
-                , sizeof(int**) * res.loader.len);
-        ASSERT(res.loader.ppHandles, ERR_OOM);
-        res.loader.pResType = realloc(res.loader.pResType
-                , sizeof(gfmAssetType) * res.loader.len);
-        ASSERT(res.loader.pResType, ERR_OOM);
+    if (res.dynIndexLen == 0) {
+        return -1;
     }
-    pResType = (gfmAssetType*)res.loader.pResType;
 
-    /* Setup the handles and calculate the memory required by the paths */
-    len = 0;
-    for (i = 0; i < numHandles; i++) {
-        pHandles[i] = -1;
-        res.loader.ppHandles[i] = pHandles + i;
-        pResType[i] = ASSET_AUDIO;
-        /* The base path (in sizeof) already accounts for the '\0' at the end */
-        len += sizeof(char) * (strlen(ppFiles[i]) + sizeof(SONG_BASE_PATH))
-                + sizeof(char**);
+    slot = hashBuf(HASH_INIT, pName, strlen(pName)) & (res.dynIndexLen - 1);
+    while (res.pDynIndex[slot] != -1) {
+        if (strcmp(pName, _getDynSongName(res.pDynIndex[slot])) == 0) {
+            return res.pDynIndex[slot];
+        }
+        slot = (slot + 1) & (res.dynIndexLen - 1);
     }
 
-    /* Setup the file paths */
-    if (len > res.loader.filesLen) {
-        res.loader.filesLen = len;
+    return -1;
+}
 
-        res.loader.pFiles = realloc(res.loader.pFiles, len);
-        ASSERT(res.loader.pFiles, ERR_OOM);
+/**
+ * Store a song on the first free slot of the hashed index.
+ *
+ * @param [ in]idx Index of the song
+ */
+static void _insertDynIndex(int idx) {
+    uint32_t slot;
+    char *pName;
+
+    pName = _getDynSongName(idx);
+    slot = hashBuf(HASH_INIT, pName, strlen(pName)) & (res.dynIndexLen - 1);
+    while (res.pDynIndex[slot] != -1) {
+        slot = (slot + 1) & (res.dynIndexLen - 1);
     }
+    res.pDynIndex[slot] = idx;
+}
 
-    len = 0;
-    for (i = 0; i < numHandles; i++) {
-        char *pName;
-        int nameLen;
-
-        pName  = (char*)(res.loader.pFiles);
-        pName += sizeof(char**) * numHandles + len;
-
-        res.loader.pFiles[i] = pName;
-
-        memcpy(pName, SONG_BASE_PATH, sizeof(SONG_BASE_PATH) - 1);
-        pName += sizeof(SONG_BASE_PATH) - 1;
+/**
+ * Add a song (already stored on pNameBuf) to the hashed index, expanding it as
+ * necessary.
+ *
+ * @param [ in]idx Index of the song
+ */
+static err _indexDynSong(int idx) {
+    /* Keep the index at most half full, so probing stays short */
+    if ((idx - SNG_MAX + 1) * 2 > res.dynIndexLen) {
+        int *pDynIndex;
+        int i, len;
+
+        len = res.dynIndexLen * 2;
+        if (len == 0) {
+            len = 16;
+        }
 
-        nameLen = strlen(ppFiles[i]);
-        memcpy(pName, ppFiles[i], nameLen);
-        pName[nameLen] = '\0';
+        pDynIndex = realloc(res.pDynIndex, sizeof(int) * len);
+        ASSERT(pDynIndex, ERR_OOM);
+        res.pDynIndex = pDynIndex;
+        res.dynIndexLen = len;
 
-        len += sizeof(SONG_BASE_PATH) + nameLen;
+        for (i = 0; i < len; i++) {
+            res.pDynIndex[i] = -1;
+        }
+        for (i = SNG_MAX; i < idx; i++) {
+            _insertDynIndex(i);
+        }
     }
 
-    res.loader.numLoading = numHandles;
-
-    res.loader.progress = 0;
-    rv = gfm_loadAssetsAsync(&res.loader.progress, game.pCtx
-            , pResType, res.loader.pFiles, res.loader.ppHandles
-            , res.loader.numLoading);
-    ASSERT((rv == GFMRV_OK), ERR_GFMERR);
-
-    return ERR_LOADINGRESOURCE;
+    _insertDynIndex(idx);
+    return ERR_OK;
 }
 
 /**
@@ -173,12 +461,14 @@ err fastGetSongIndex(int *pIdx, char *pName) {
     ASSERT(pIdx != 0, ERR_ARGUMENTBAD);
     ASSERT(pName != 0, ERR_ARGUMENTBAD);
 
-    for (tmp = SFX_MAX; tmp < SFX_MAX + SNG_MAX; tmp++) {
-        char *pFilename = _pResSrc[tmp] + sizeof(SONG_BASE_PATH) - 1;
+    /* Every song has its own slot, so simply check if it's the one there */
+    tmp = _songHashTable[hashBuf(SONG_HASH_SEED, pName, strlen(pName))
+            & (SONG_HASH_SIZE - 1)];
+    if (tmp != -1) {
+        char *pFilename = _pResSrc[SFX_MAX + tmp] + sizeof(SONG_BASE_PATH) - 1;
 
         if (strcmp(pFilename, pName) == 0) {
-            idx = tmp - SFX_MAX;
-            break;
+            idx = tmp;
         }
     }
 
@@ -193,16 +483,22 @@ err fastGetSongIndex(int *pIdx, char *pName) {
 
     /* Check if the asset has already been loaded */
     *pIdx = idx;
-    return _checkHandleLoaded(idx);
+    if (_checkHandleLoaded(idx) != ERR_OK) {
+        err erv;
+
+        erv = _requestSong(idx, pName);
+        ASSERT(erv == ERR_OK, erv);
+        return ERR_LOADINGRESOURCE;
+    }
+    return ERR_OK;
 }
 
 /**
  * Check if a song has been dynamically loaded into the game and return the
- * index of its handle. If not found, but another resource is currently being
- * loaded, ERR_ALREADYLOADING shall be returned. If the songs has already been
- * added to the game but hasn't finished loading, ERR_LOADINGRESOURCE shall be
- * returned. If it does not exist in the pre-loaded list, ERR_INDEXOOB is
- * returned instead.
+ * index of its handle. If not found, it's queued to be loaded (ahead of any
+ * previously requested song) and ERR_LOADINGRESOURCE is returned. The same
+ * error is returned if the song was already queued but hasn't finished loading.
+ * If the loader's queue is full, ERR_ALREADYLOADING shall be returned.
  *
  * If either ERR_LOADINGRESOURCE or ERR_OK is returned, pIdx shall point to a
  * valid index, which may later be queried through getResourceHandle(idx).
@@ -211,7 +507,7 @@ err fastGetSongIndex(int *pIdx, char *pName) {
  * @param  [ in]pName Name of the song getting searched. Must be '\0' terminated
  */
 err getDynSongIndex(int *pIdx, char *pName) {
-    char *ppFiles[1];
+    err erv;
     int idx, len;
 
     ASSERT(pIdx != 0, ERR_ARGUMENTBAD);
@@ -219,17 +515,24 @@ err getDynSongIndex(int *pIdx, char *pName) {
 
     /* Check if the songs has already been loaded, or if it's currently being
      * loaded */
-    for (idx = SNG_MAX; idx < res.count; idx++) {
-        if (strcmp(pName, _getDynSongName(idx)) == 0) {
-            *pIdx = idx;
-            return _checkHandleLoaded(*pIdx);
+    idx = _findDynSong(pName);
+    if (idx != -1) {
+        *pIdx = idx;
+        if (_checkHandleLoaded(idx) != ERR_OK) {
+            erv = _requestSong(idx, pName);
+            ASSERT(erv == ERR_OK, erv);
+            return ERR_LOADINGRESOURCE;
         }
+        return ERR_OK;
     }
 
-    /* Check if anything else is currently being loaded */
-    ASSERT(res.loader.progress == -1 ||
-            res.loader.progress == res.loader.numLoading, ERR_ALREADYLOADING);
-
+    /* The new song is appended after every other one */
+    if (res.count > SNG_MAX) {
+        idx = res.count;
+    }
+    else {
+        idx = SNG_MAX;
+    }
     len = strlen(pName);
 
     /* Ensure there's enough memory for the new song */
@@ -266,44 +569,114 @@ err getDynSongIndex(int *pIdx, char *pName) {
      * NOTE: idx already points to the next index */
     memcpy(res.pNameBuf + res.usedNameBuf, pName, len + 1);
     res.pDynSong[idx] = res.usedNameBuf;
+
+    erv = _requestSong(idx, pName);
+    ASSERT(erv == ERR_OK, erv);
+    erv = _indexDynSong(idx);
+    ASSERT(erv == ERR_OK, erv);
+
     res.usedNameBuf += len + 1;
     res.count++;
     /* Set the return value */
     *pIdx = idx;
 
-    ppFiles[0] = _getDynSongName(idx);
-    return startLoadingResources(res.pHandles + idx, ppFiles, 1/*numHandles*/);
+    return ERR_LOADINGRESOURCE;
 }
 
 /**
- * Setup the resources with the hard-coded/pre-initialized songs and start
- * loading it.
+ * Setup the resources with the hard-coded/pre-initialized songs and queue
+ * every sound effect. Songs are only queued once requested.
  */
 err initResource() {
-    gfmRV rv;
+    err erv;
     int i = 0;
 
     /* Setup _pResHnd from sfx.* and from _songHandleList */
-#define X(name, ...) _pResHnd[i++] = &sfx.name,
+#define X(name, ...) _pResHnd[i++] = &sfx.name;
     SOUNDS_LIST
 #undef X
     for (i = 0; i < SNG_MAX; i++) {
-        _pResHnd[i] = _songHandleList + i;
         _songHandleList[i] = -1;
     }
-    for (i = 0; i < SFX_MAX + SNG_MAX; i++) {
-        _pResType[i] = ASSET_AUDIO;
-    }
     /* Although res.pHandles initially point to _songHandleList, keeping
      * res.len == 0 causes it to be expanded on the firts unloaded resource */
     res.pHandles = _songHandleList;
 
-    /* Start loading everything */
-    res.loader.numLoading = SFX_MAX + SNG_MAX;
+    /* Queue every sound effect. Songs are only decoded once requested, so
+     * tracks that won't be played don't take any memory */
+    for (i = 0; i < SFX_MAX; i++) {
+        erv = _queueResource(SFX_BASE_PATH
+                , _pResSrc[i] + sizeof(SFX_BASE_PATH) - 1, i, RES_PRIO_SFX);
+        ASSERT(erv == ERR_OK, erv);
+    }
 
-    rv = gfm_loadAssetsAsync(&res.loader.progress, game.pCtx, _pResType
-            , _pResSrc, _pResHnd, res.loader.numLoading);
-    ASSERT((rv == GFMRV_OK), ERR_GFMERR);
+    return ERR_OK;
+}
+
+/**
+ * Collect every resource that finished loading (appending it to the completion
+ * list) and start loading the next ones on the queue. Must be called every
+ * frame.
+ *
+ * GFraMe's loading thread has no completion callback, so this polls each job's
+ * progress, exactly as the loadstate always did. Nothing here synchronizes with
+ * that thread: the handle is only valid because GFraMe stores it before
+ * progress. Both ends of the completion list run on the main thread, so the
+ * list itself isn't shared with the loading thread.
+ */
+err updateResourceLoader() {
+    err erv;
+    int i;
+
+    for (i = 0; i < LOADER_MAX_JOBS; i++) {
+        loaderJob *pJob = _jobs + i;
+
+        /* GFraMe writes progress with a plain store, so the atomic load only
+         * keeps the poll from being cached. It doesn't order the loading
+         * thread's writes (see above) */
+        if (pJob->state != JOB_LOADING || ATOMIC_LOAD(&pJob->progress) < 1) {
+            continue;
+        }
+
+        /* Only the main thread touches the handle lists, so it's safe even
+         * if they were expanded while loading */
+        *_getResourceHandle(pJob->dst) = pJob->handle;
+        erv = _postCompletion(pJob);
+        ASSERT(erv == ERR_OK, erv);
+
+        /* The loading thread can't be traced directly, so the decode is
+         * traced from when it started until it was noticed to be done */
+        if (pJob->traceStart != 0) {
+            traceEvent(pJob->pPath + pJob->nameOffset
+                    , TRACE_TID_LOADER, pJob->traceStart
+                    , clockGetUs());
+        }
+        if (pJob->priority == RES_PRIO_SFX) {
+            res.loader.progress++;
+            res.loader.numSfx--;
+        }
+        res.loader.numInFlight--;
+        pJob->state = JOB_FREE;
+    }
+    if (res.loader.progress == res.loader.numLoading) {
+        res.loader.progress = 0;
+        res.loader.numLoading = 0;
+    }
+
+    while (res.loader.numInFlight < LOADER_MAX_IN_FLIGHT && _queueLen > 0) {
+        loaderJob *pJob;
+        gfmRV rv;
+
+        pJob = _jobs + _popQueue();
+        pJob->state = JOB_LOADING;
+        res.loader.numInFlight++;
+
+        pJob->traceStart = traceBegin();
+
+        rv = gfm_loadAssetsAsync(&pJob->progress, game.pCtx, &pJob->type
+                , &pJob->pFile, &pJob->pHandle, 1/*numAssets*/);
+        ASSERT((rv == GFMRV_OK), ERR_GFMERR);
+    }
 
     return ERR_OK;
 }
@@ -317,9 +690,7 @@ void cleanResource() {
     }
     free(res.pNameBuf);
     free(res.pDynSong);
-    free(res.loader.ppHandles);
-    free(res.loader.pResType);
-    free(res.loader.pFiles);
+    free(res.pDynIndex);
 }
 
 /**
@@ -327,28 +698,32 @@ void cleanResource() {
  * currently being loaded, "" is returned.
  */
 char *getCurrentResourceName() {
-    int idx;
+    loaderJob *pCur = 0;
+    int i;
 
-    if (res.pHandles == _songHandleList) {
-        /* Still loading the first few hard-coded resources */
-        if (res.loader.progress < SFX_MAX) {
-            idx = sizeof(SFX_BASE_PATH) - 1;
-        }
-        else if (res.loader.progress < SFX_MAX + SNG_MAX) {
-            idx = sizeof(SONG_BASE_PATH) - 1;
-        }
-        else {
-            return "";
-        }
+    /* Report the blocking resource that has been loading for the longest */
+    for (i = 0; i < LOADER_MAX_JOBS; i++) {
+        loaderJob *pJob = _jobs + i;
 
-        return _pResSrc[res.loader.progress] + idx;
+        if (pJob->state == JOB_LOADING
+                && pJob->priority == RES_PRIO_SFX
+                && (pCur == 0 || pJob->seq < pCur->seq)) {
+            pCur = pJob;
+        }
     }
 
-    idx = res.count - res.loader.numLoading + res.loader.progress;
-    if (idx >= res.count) {
+    if (pCur == 0) {
         return "";
     }
-    return _getDynSongName(idx);
+    return pCur->pPath + pCur->nameOffset;
+}
+
+/**
+ * Get how many resources are waiting to be loaded (not counting the ones
+ * currently loading).
+ */
+int getLoaderQueueLength() {
+    return _queueLen;
 }
 
 /**
@@ -362,7 +737,7 @@ int isLoading() {
  * Whether every SFX has already been loaded. Return 0 if false.
  */
 int isPastSfx() {
-    return (res.pHandles != _songHandleList) || (res.loader.progress >= SFX_MAX);
+    return res.loader.numSfx == 0;
 }
 
 /**
@@ -373,4 +748,3 @@ int isPastSfx() {
 int getSongHandle(int idx) {
     return res.pHandles[idx];
 }
-
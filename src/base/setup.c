@@ -3,10 +3,15 @@
  *
  * Implement all initial setup
  */
+#include <base/batch.h>
 #include <base/cmdParse.h>
+#include <base/framepacer.h>
 #include <base/game.h>
 #include <base/input.h>
+#include <base/loopback.h>
+#include <base/replay.h>
 #include <base/setup.h>
+#include <base/trace.h>
 #include <conf/config.h>
 #include <conf/game.h>
 
@@ -70,6 +75,13 @@ err setupGame(int argc, char *argv[]) {
     rv = gfm_setBackground(game.pCtx, BG_COLOR);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
+#if defined(JJATENGINE)
+    /* Simulations run by the batch runner (or by the bot) never play
+     * anything */
+    if (config.pBatchFile != 0 || config.pBotLevel != 0) {
+        config.flags |= CFG_NOAUDIO;
+    }
+#endif /* JJATENGINE */
     if (config.flags & CFG_NOAUDIO) {
         rv = gfm_disableAudio(game.pCtx);
         ASSERT(rv == GFMRV_OK, ERR_GFMERR);
@@ -88,6 +100,28 @@ err setupGame(int argc, char *argv[]) {
             config.fpsQuality);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
+    /* Sleeping would only add latency if VSync already blocks the game */
+    erv = initFramePacer(config.fpsQuality, config.maxFrameskip
+            , !(config.flags & CFG_VSYNC));
+    ASSERT(erv == ERR_OK, erv);
+
+    if (config.pTraceFile != 0) {
+        erv = startTrace(config.pTraceFile);
+        ASSERT(erv == ERR_OK, erv);
+    }
+
+    /* A game is either recorded or replayed, never both */
+    ASSERT(config.pRecordFile == 0 || config.pReplayFile == 0
+            , ERR_ARGUMENTBAD);
+    if (config.pRecordFile != 0) {
+        erv = startRecording(config.pRecordFile);
+        ASSERT(erv == ERR_OK, erv);
+    }
+    else if (config.pReplayFile != 0) {
+        erv = startReplay(config.pReplayFile);
+        ASSERT(erv == ERR_OK, erv);
+    }
+
     /* By default, render the FPS counter on debug mode */
     rv = gfm_showFPSCounter(game.pCtx);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
@@ -119,6 +153,32 @@ err setupGame(int argc, char *argv[]) {
         ASSERT(erv == ERR_OK, erv);
         game.flags |= CMD_CUSTOMINPUT;
     }
+
+    /* Netplay itself only starts with the main loop, since it depends on the
+     * playstate */
+    if (config.netplayLatency >= 0) {
+        ASSERT(config.netplayLoss >= 0 && config.netplayLoss <= 100
+                , ERR_ARGUMENTBAD);
+        configureLoopback(config.netplayLatency, config.netplayLoss);
+        game.flags |= CMD_NETPLAY;
+    }
+
+    /* The tools bound to the window are shared by every simulation, so they
+     * can't be used by the batch runner */
+    if (config.pBatchFile != 0) {
+        ASSERT(config.pTraceFile == 0 && config.pRecordFile == 0
+                && config.pReplayFile == 0 && config.netplayLatency < 0
+                , ERR_ARGUMENTBAD);
+        erv = initBatch(config.pBatchFile, config.batchWorkers);
+        ASSERT(erv == ERR_OK, erv);
+        game.flags |= CMD_BATCH;
+    }
+    else if (config.pBotLevel != 0) {
+        ASSERT(config.pRecordFile == 0 && config.pReplayFile == 0
+                && config.netplayLatency < 0, ERR_ARGUMENTBAD);
+        game.pBotLevel = config.pBotLevel;
+        game.flags |= CMD_BOT;
+    }
 #endif /* JJATENGINE */
 
 #if defined(DEBUG)
@@ -85,6 +85,43 @@ static err _playSong(int idx) {
     return ERR_OK;
 }
 
+/**
+ * Retrieve a song's index, queueing it to be decoded if it isn't loaded yet.
+ * Decoded songs stay loaded, so this only ever decodes a song once.
+ *
+ * @param  [out]pIdx  Index of the song
+ * @param  [ in]pName The name of the song
+ * @return            ERR_OK, ERR_LOADINGRESOURCE (if queued) or an error
+ */
+static err _getSongIndex(int *pIdx, char *pName) {
+    err erv;
+
+    erv = fastGetSongIndex(pIdx, pName);
+    if (erv == ERR_INDEXOOB) {
+        erv = getDynSongIndex(pIdx, pName);
+    }
+
+    return erv;
+}
+
+/**
+ * Start decoding a song that will soon be played (e.g., the next level's),
+ * without playing it. If the loader's queue is full, it's simply decoded once
+ * actually played.
+ *
+ * @param  [ in]pName The name of the song
+ */
+err prefetchSong(char *pName) {
+    err erv;
+    int idx;
+
+    erv = _getSongIndex(&idx, pName);
+    ASSERT(erv == ERR_OK || erv == ERR_LOADINGRESOURCE
+            || erv == ERR_ALREADYLOADING, erv);
+
+    return ERR_OK;
+}
+
 /**
  * Check if a song is currently loaded and, if not, start loading it.
  *
@@ -94,10 +131,7 @@ err playSong(char *pName) {
     err erv;
     int idx;
 
-    erv = fastGetSongIndex(&idx, pName);
-    if (erv == ERR_INDEXOOB) {
-        erv = getDynSongIndex(&idx, pName);
-    }
+    erv = _getSongIndex(&idx, pName);
     ASSERT(erv == ERR_OK || erv == ERR_LOADINGRESOURCE, erv);
 
     if (erv == ERR_LOADINGRESOURCE) {
@@ -111,15 +145,22 @@ err playSong(char *pName) {
 }
 
 /**
- * If any song was left pending, start playing it
+ * Drain every resource that finished loading and, if the pending song is among
+ * them, start playing it
  */
 err playPendingSong() {
-    int idx = sfx.pending;
+    resourceCompletion done;
+    int play = 0;
 
-    if (idx != -1 && getSongHandle(idx) != -1) {
-        return _playSong(idx);
+    while (popResourceCompletion(&done)) {
+        if (done.isSong && done.idx == sfx.pending) {
+            play = 1;
+        }
     }
 
+    if (play) {
+        return _playSong(sfx.pending);
+    }
     return ERR_OK;
 }
 
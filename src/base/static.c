@@ -1,41 +1,67 @@
 /**
  * @file src/base/static.c
  *
- * Declare all static variables/contexts.
+ * Declare all static variables/contexts. Those belonging to the simulation are
+ * thread-local (see base/simulation.h).
  */
+#include <base/batch.h>
 #include <base/collision.h>
+#include <base/framepacer.h>
 #include <base/game.h>
 #include <base/gfx.h>
 #include <base/input.h>
 #include <base/loadstate.h>
+#include <base/loopback.h>
+#include <base/perfoverlay.h>
+#include <base/replay.h>
 #include <base/resource.h>
 #include <base/sfx.h>
+#include <base/simulation.h>
+#include <base/trace.h>
 
 #include <string.h>
 
 /** Game context */
-gameCtx game;
+SIM_LOCAL gameCtx game;
 /** Graphics context */
 gfxCtx gfx;
 /** Input context */
-inputCtx input;
+SIM_LOCAL inputCtx input;
 /** Collision context */
-collisionCtx collision;
+SIM_LOCAL collisionCtx collision;
 /** The game's loadstate */
 loadstateCtx loadstate;
 /** The game's resource loader */
 resourceCtx res;
 /** Sound context */
 sfxCtx sfx;
+/** Frame pacing governor */
+framePacerCtx pacer;
+/** Performance overlay */
+perfOverlayCtx perf;
+/** Trace recorder */
+traceCtx trace;
+/** Input recorder/player */
+SIM_LOCAL replayCtx replay;
+/** Loopback transport */
+SIM_LOCAL loopbackCtx loopback;
+/** Batch runner */
+batchCtx batch;
 
 /** Initialize the uninitialized globals with all-zeros. */
 void zeroizeGlobalCtx() {
+    memset(&batch, 0x0, sizeof(batchCtx));
     memset(&collision, 0x0, sizeof(collisionCtx));
+    memset(&pacer, 0x0, sizeof(framePacerCtx));
     memset(&game, 0x0, sizeof(gameCtx));
     memset(&gfx, 0x0, sizeof(gfxCtx));
     memset(&input, 0x0, sizeof(inputCtx));
     memset(&loadstate, 0x0, sizeof(loadstateCtx));
+    memset(&loopback, 0x0, sizeof(loopbackCtx));
+    memset(&perf, 0x0, sizeof(perfOverlayCtx));
+    memset(&replay, 0x0, sizeof(replayCtx));
     memset(&res, 0x0, sizeof(resourceCtx));
     memset(&sfx, 0x0, sizeof(sfxCtx));
+    memset(&trace, 0x0, sizeof(traceCtx));
 }
 
@@ -0,0 +1,131 @@
+/**
+ * @file src/base/trace.c
+ *
+ * Record scoped events as Chrome's trace-event JSON.
+ */
+#include <base/clock.h>
+#include <base/error.h>
+#include <base/trace.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Write a thread's name, so its track is labeled on the timeline.
+ *
+ * @param  [ in]tid   The thread's track
+ * @param  [ in]pName The thread's name
+ */
+static void _nameTrack(int tid, char *pName) {
+    fprintf(trace.pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1"
+            ",\"tid\":%i,\"args\":{\"name\":\"%s\"}}"
+            , (trace.count > 0) ? ",\n" : "", tid, pName);
+    trace.count++;
+}
+
+/**
+ * Start recording events.
+ *
+ * @param  [ in]pPath Where the trace should be written
+ */
+err startTrace(char *pPath) {
+    ASSERT(pPath != 0, ERR_ARGUMENTBAD);
+    ASSERT(trace.pFile == 0, ERR_ARGUMENTBAD);
+
+    trace.pFile = fopen(pPath, "w");
+    ASSERT(trace.pFile != 0, ERR_OPENFILE);
+    trace.origin = clockGetUs();
+    trace.count = 0;
+
+    fprintf(trace.pFile, "[\n");
+    _nameTrack(TRACE_TID_MAIN, "main");
+    _nameTrack(TRACE_TID_LOADER, "loader");
+
+    return ERR_OK;
+}
+
+/** Stop recording events and close the trace's file */
+void stopTrace() {
+    if (trace.pFile == 0) {
+        return;
+    }
+
+    fprintf(trace.pFile, "\n]\n");
+    fclose(trace.pFile);
+    trace.pFile = 0;
+}
+
+/** Start/stop recording into TRACE_DEFAULT_FILE */
+err toggleTrace() {
+    if (trace.pFile != 0) {
+        stopTrace();
+        return ERR_OK;
+    }
+    return startTrace(TRACE_DEFAULT_FILE);
+}
+
+/**
+ * Retrieve the start of a scoped event. Returns 0 when not recording.
+ */
+uint64_t traceBegin() {
+    if (trace.pFile == 0) {
+        return 0;
+    }
+    return clockGetUs();
+}
+
+/**
+ * Record a scoped event on any track (e.g., one that run on another thread).
+ *
+ * @param  [ in]pName Name of the event
+ * @param  [ in]tid   The event's track
+ * @param  [ in]start Value returned by traceBegin
+ * @param  [ in]end   When the event finished, in microseconds
+ */
+void traceEvent(char *pName, int tid, uint64_t start, uint64_t end) {
+    /* Skip events that started before recording (e.g., on a previous one) */
+    if (trace.pFile == 0 || start < trace.origin) {
+        return;
+    }
+
+    /* The timestamps are printed as doubles, since not every libc supports
+     * printing 64 bits integers */
+    fprintf(trace.pFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i"
+            ",\"ts\":%.0f,\"dur\":%.0f}", (trace.count > 0) ? ",\n" : ""
+            , pName, tid, (double)(start - trace.origin)
+            , (double)(end - start));
+    trace.count++;
+}
+
+/**
+ * Finish a scoped event on the main thread's track. Nothing is recorded if
+ * start is 0 (i.e., recording wasn't active when the scope started).
+ *
+ * @param  [ in]start Value returned by traceBegin
+ * @param  [ in]pName Name of the event
+ */
+void traceEnd(uint64_t start, char *pName) {
+    if (start == 0 || trace.pFile == 0) {
+        return;
+    }
+    traceEvent(pName, TRACE_TID_MAIN, start, clockGetUs());
+}
+
+/**
+ * Finish a scoped event and start the next one, to split a long scope into
+ * sequential steps.
+ *
+ * @param  [io]pStart Value returned by traceBegin (updated for the next step)
+ * @param  [ in]pName Name of the finished step
+ */
+void traceStep(uint64_t *pStart, char *pName) {
+    uint64_t now;
+
+    if (*pStart == 0 || trace.pFile == 0) {
+        return;
+    }
+
+    now = clockGetUs();
+    traceEvent(pName, TRACE_TID_MAIN, *pStart, now);
+    *pStart = now;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file src/batch.c
+ *
+ * Run a single headless simulation for the batch runner. Just like the main
+ * loop, this is implemented here (instead of on src/base/) since it's specific
+ * to the game.
+ */
+#include <base/batch.h>
+#include <base/clock.h>
+#include <base/collision.h>
+#include <base/error.h>
+#include <base/game.h>
+#include <base/replay.h>
+
+#include <conf/state.h>
+
+#include <jjat2/fx_group.h>
+#include <jjat2/hitbox.h>
+#include <jjat2/leveltransition.h>
+#include <jjat2/playstate.h>
+#include <jjat2/static.h>
+#include <jjat2/ui.h>
+
+#include <stdint.h>
+
+/**
+ * Simulate every frame of the job's recording.
+ *
+ * @param  [ in]pJob The job
+ */
+static err _simulate(batchJob *pJob) {
+    err erv;
+
+    /* Set initial state */
+    erv = getLevelId(&playstate.firstLevel, pJob->pLevel);
+    ASSERT(erv == ERR_OK, erv);
+    game.nextState = ST_PLAYSTATE;
+
+    while (1) {
+        uint64_t start, elapsed;
+
+        /* Switch state */
+        if (game.nextState != ST_NONE) {
+            switch (game.nextState) {
+                case ST_PLAYSTATE: erv = loadPlaystate(); break;
+                case ST_LEVELTRANSITION: erv = setupLeveltransition(); break;
+                default: erv = ERR_NOTIMPLEMENTED;
+            }
+            ASSERT(erv == ERR_OK, erv);
+
+            game.currentState = game.nextState;
+            game.nextState = ST_NONE;
+        }
+
+        erv = replayFrameInput();
+        ASSERT(erv == ERR_OK, erv);
+        if (replay.mode != RM_PLAY) {
+            /* The recording is over */
+            break;
+        }
+
+        start = clockGetUs();
+        switch (game.currentState) {
+            case ST_PLAYSTATE: erv = simulatePlaystate(); break;
+            case ST_LEVELTRANSITION: erv = updateLeveltransition(); break;
+            default: erv = ERR_NOTIMPLEMENTED;
+        }
+        ASSERT(erv == ERR_OK, erv);
+        elapsed = clockGetUs() - start;
+
+        pJob->totalUs += elapsed;
+        if (elapsed > pJob->maxUs) {
+            pJob->maxUs = elapsed;
+        }
+
+        erv = replayFrameState();
+        ASSERT(erv == ERR_OK, erv);
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Run a single job on the current thread. The thread's GFraMe context must have
+ * already been set on game.
+ *
+ * @param  [ in]pJob The job
+ */
+err simulateBatchJob(batchJob *pJob) {
+    err erv;
+
+    zeroizeGameGlobalCtx();
+    game.currentState = ST_NONE;
+    game.nextState = ST_NONE;
+
+    erv = setupCollision();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    erv = initPlaystate();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    erv = initFxGroup();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    erv = initLeveltransition();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    erv = initUI();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    erv = initHitboxes();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+
+    replay.frame = 0;
+    replay.divergedAt = -1;
+    erv = startReplay(pJob->pReplay);
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    replay.quiet = 1;
+
+    erv = _simulate(pJob);
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+
+    pJob->hash = getSimulationHash();
+    erv = ERR_OK;
+__ret:
+    pJob->frames = replay.frame;
+    pJob->divergedAt = replay.divergedAt;
+    stopReplay();
+    replay.quiet = 0;
+
+    freeHitboxes();
+    freeUI();
+    freeLeveltransition();
+    freeFxGroup();
+    freePlaystate();
+    cleanCollision();
+
+    return erv;
+}
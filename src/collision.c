@@ -92,7 +92,7 @@ static void _explodeStar(collisionNode *bullet) {
     int x, y;
 
     gfmSprite_getPosition(&x, &y, bullet->pSprite);
-    gfmGroup_removeNode((gfmGroupNode*)bullet->pChild);
+    removeFx((gfmGroupNode*)bullet->pChild);
     pSpr = spawnFx(x, y, 4/*w*/, 4/*h*/, 0/*dir*/, 250/*ttl*/, FX_STAR_EXPLOSION
             , T_FX);
     if (pSpr) {
@@ -208,14 +208,14 @@ static inline err _defaultFloorCollision(collisionNode *floor
 static inline err _ignoreTeleportBullet(collisionNode *bullet
         , collisionNode *other) {
     gfmGroupNode *pNode;
-    gfmRV rv;
+    err erv;
 
     CHECK_OVERLAP(bullet, other);
 
     pNode = (gfmGroupNode*)bullet->pChild;
     /* TODO Play vanish animation */
-    rv = gfmGroup_removeNode(pNode);
-    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    erv = removeFx(pNode);
+    ASSERT(erv == ERR_OK, erv);
 
 #if !defined(DEBUG)
     if (other->type == T_TEL_BULLET) {
@@ -233,7 +233,6 @@ static inline err _setTeleportEntity(collisionNode *bullet
     gfmGroupNode *pNode;
     entityCtx *pEntity;
     err erv;
-    gfmRV rv;
 
     CHECK_OVERLAP(bullet, other);
 
@@ -248,8 +247,8 @@ static inline err _setTeleportEntity(collisionNode *bullet
             ASSERT(erv == ERR_OK, erv);
         }
     }
-    rv = gfmGroup_removeNode(pNode);
-    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    erv = removeFx(pNode);
+    ASSERT(erv == ERR_OK, erv);
 
     collision.flags |= CF_SKIP;
     return ERR_OK;
@@ -309,8 +308,8 @@ static inline err _setTeleportFloor(collisionNode *bullet
         erv = teleporterTargetPosition(x, y, pos);
         ASSERT(erv == ERR_OK, erv);
     }
-    rv = gfmGroup_removeNode(pNode);
-    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    erv = removeFx(pNode);
+    ASSERT(erv == ERR_OK, erv);
 
     collision.flags |= CF_SKIP;
     return ERR_OK;
@@ -478,25 +477,6 @@ static inline err _entityCollision(collisionNode *entA, collisionNode *entB) {
     }
 }
 
-/** Collision between a g_walky's view and an entity */
-static inline err _gWalkyViewEntityCollision(collisionNode *entity
-        , collisionNode *view) {
-    if (entity->pChild == view->pChild) {
-        /* Avoid triggering for the viewing entity */
-        return ERR_OK;
-    }
-    else if (!(((entityCtx*)entity->pChild)->flags & EF_ALIVE)) {
-        /* Avoid triggering for dead/just hit entity */
-        return ERR_OK;
-    }
-
-    CHECK_OVERLAP(entity, view);
-
-    triggerGreenWalkyAttack((entityCtx*)view->pChild);
-
-    return ERR_OK;
-}
-
 /** Collision between a sword attack and a projectile */
 static inline err _swordReflectProjectile(collisionNode *sword
         , collisionNode *projectile) {
@@ -558,7 +538,7 @@ static inline err _onPressurePad(collisionNode *entity
 
     if (GFMRV_TRUE ==
             gfmObject_isOverlaping(entity->pObject, pressurePad->pObject)) {
-        pressPressurePad((entityCtx*)pressurePad->pChild);
+        return pressPressurePad((entityCtx*)pressurePad->pChild);
     }
 
     return ERR_OK;
@@ -591,6 +571,7 @@ err doCollide(gfmQuadtreeRoot *pQt) {
         ASSERT(rv == GFMRV_OK, ERR_GFMERR);
         _getSubtype(&node1);
         _getSubtype(&node2);
+        collision.pairs++;
 
         /* Import the filtered collision tuples */
         #include <auto/collisioncases.c>
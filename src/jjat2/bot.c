@@ -0,0 +1,375 @@
+/**
+ * @file src/jjat2/bot.c
+ *
+ * Step the simulation from a bot's buttons, observing it after every frame.
+ *
+ * The frame time follows the same fixed pattern as the game running at
+ * BOT_FPS (e.g., 17ms, 17ms, 16ms, ...), so stepping is fully deterministic.
+ */
+#include <base/collision.h>
+#include <base/error.h>
+#include <base/game.h>
+#include <base/input.h>
+
+#include <conf/state.h>
+#include <conf/type.h>
+
+#include <GFraMe/gfmError.h>
+#include <GFraMe/gfmInput.h>
+#include <GFraMe/gfmSprite.h>
+
+#include <jjat2/bot.h>
+#include <jjat2/entity.h>
+#include <jjat2/fx_group.h>
+#include <jjat2/hitbox.h>
+#include <jjat2/leveltransition.h>
+#include <jjat2/playstate.h>
+#include <jjat2/static.h>
+#include <jjat2/tilequery.h>
+#include <jjat2/ui.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG(...) printf(__VA_ARGS__)
+
+/** Frame rate simulated by the bot */
+#define BOT_FPS 60
+
+/**
+ * Overwrite a button's state from whether it's pressed on this and on the
+ * previous frame.
+ *
+ * @param  [ in]pButton    The button
+ * @param  [ in]isPressed  Whether it's pressed on this frame
+ * @param  [ in]wasPressed Whether it was pressed on the previous frame
+ */
+static void _setButton(button *pButton, int isPressed, int wasPressed) {
+    if (isPressed && wasPressed) {
+        pButton->state = gfmInput_pressed;
+    }
+    else if (isPressed) {
+        pButton->state = gfmInput_justPressed;
+        pButton->numPressed++;
+    }
+    else if (wasPressed) {
+        pButton->state = gfmInput_justReleased;
+    }
+    else {
+        pButton->state = gfmInput_released;
+    }
+}
+
+/**
+ * Overwrite the characters' buttons from the bot's bit-mask.
+ *
+ * @param  [ in]buttons Bit-mask of the pressed buttons
+ */
+static void _applyButtons(uint8_t buttons) {
+    uint8_t prev = bot.buttons;
+
+#define SET_BUTTON(name, bit) \
+    _setButton(&input.name, buttons & (bit), prev & (bit))
+    SET_BUTTON(swordyLeft, BOT_LEFT);
+    SET_BUTTON(swordyRight, BOT_RIGHT);
+    SET_BUTTON(swordyJump, BOT_JUMP);
+    SET_BUTTON(swordyAtk, BOT_ATK);
+    SET_BUTTON(gunnyLeft, BOT_LEFT << BOT_GUNNY_SHIFT);
+    SET_BUTTON(gunnyRight, BOT_RIGHT << BOT_GUNNY_SHIFT);
+    SET_BUTTON(gunnyJump, BOT_JUMP << BOT_GUNNY_SHIFT);
+    SET_BUTTON(gunnyAtk, BOT_ATK << BOT_GUNNY_SHIFT);
+#undef SET_BUTTON
+
+    bot.buttons = buttons;
+}
+
+/**
+ * Observe a single player.
+ *
+ * @param  [out]pObs The observation
+ * @param  [ in]pEnt The player
+ */
+static void _observePlayer(botPlayer *pObs, entityCtx *pEnt) {
+    int h, w, x, y, tx, ty, i, j;
+
+    gfmSprite_getPosition(&x, &y, pEnt->pSelf);
+    gfmSprite_getDimensions(&w, &h, pEnt->pSelf);
+    pObs->x = (int16_t)x;
+    pObs->y = (int16_t)y;
+
+    /* Tile on the top-left corner of the view */
+    tx = (x + w / 2) / TILE_DIMENSION - BOT_VIEW_WIDTH / 2;
+    ty = (y + h / 2) / TILE_DIMENSION - BOT_VIEW_HEIGHT / 2;
+    for (j = 0; j < BOT_VIEW_HEIGHT; j++) {
+        for (i = 0; i < BOT_VIEW_WIDTH; i++) {
+            int type;
+
+            type = getTileType(tx + i, ty + j);
+            pObs->pTiles[j][i] = (uint16_t)TYPE(type);
+        }
+    }
+}
+
+/** Switch to the next state, if any */
+static err _switchState() {
+    err erv;
+
+    if (game.nextState == ST_NONE) {
+        return ERR_OK;
+    }
+
+    switch (game.nextState) {
+        case ST_PLAYSTATE: erv = loadPlaystate(); break;
+        case ST_LEVELTRANSITION: erv = setupLeveltransition(); break;
+        default: erv = ERR_NOTIMPLEMENTED;
+    }
+    ASSERT(erv == ERR_OK, erv);
+
+    game.currentState = game.nextState;
+    game.nextState = ST_NONE;
+
+    return ERR_OK;
+}
+
+/** Initialize the simulation so it may be stepped by the bot */
+err initBot() {
+    err erv;
+
+    ASSERT(game.pCtx != 0, ERR_ARGUMENTBAD);
+    ASSERT(!bot.isInit, ERR_ARGUMENTBAD);
+
+    zeroizeGameGlobalCtx();
+    memset(&input, 0x0, sizeof(inputCtx));
+    game.currentState = ST_NONE;
+    game.nextState = ST_NONE;
+    /* Bots never play anything */
+    game.flags |= CMD_HEADLESS;
+    bot.isInit = 1;
+
+    erv = setupCollision();
+    ASSERT(erv == ERR_OK, erv);
+    erv = initPlaystate();
+    ASSERT(erv == ERR_OK, erv);
+    erv = initFxGroup();
+    ASSERT(erv == ERR_OK, erv);
+    erv = initLeveltransition();
+    ASSERT(erv == ERR_OK, erv);
+    erv = initUI();
+    ASSERT(erv == ERR_OK, erv);
+    erv = initHitboxes();
+    ASSERT(erv == ERR_OK, erv);
+
+    return ERR_OK;
+}
+
+/** Release the bot's simulation */
+void freeBot() {
+    if (!bot.isInit) {
+        return;
+    }
+
+    freeHitboxes();
+    freeUI();
+    freeLeveltransition();
+    freeFxGroup();
+    freePlaystate();
+    cleanCollision();
+    memset(&bot, 0x0, sizeof(botCtx));
+}
+
+/**
+ * Load a level, placing the players on its starting position.
+ *
+ * @param  [ in]pLevel The level
+ */
+err resetBot(char *pLevel) {
+    err erv;
+
+    ASSERT(bot.isInit, ERR_ARGUMENTBAD);
+
+    erv = getLevelId(&bot.level, pLevel);
+    ASSERT(erv == ERR_OK, erv);
+    playstate.firstLevel = bot.level;
+    clearPlaystateLevelFlag();
+    bot.frame = 0;
+    bot.buttons = 0;
+    _applyButtons(0);
+
+    game.nextState = ST_PLAYSTATE;
+    return _switchState();
+}
+
+/**
+ * Retrieve the observation of the current frame.
+ *
+ * @param  [out]pObs The observation
+ */
+void observeBot(botObservation *pObs) {
+    _observePlayer(&pObs->swordy, &playstate.swordy);
+    _observePlayer(&pObs->gunny, &playstate.gunny);
+    pObs->frame = bot.frame;
+
+    pObs->status = 0;
+    if (!(playstate.killed & AC_SWORDY)) {
+        pObs->status |= BOT_SWORDY_ALIVE;
+    }
+    if (!(playstate.killed & AC_GUNNY)) {
+        pObs->status |= BOT_GUNNY_ALIVE;
+    }
+    if (game.currentState == ST_LEVELTRANSITION
+            || game.nextState == ST_LEVELTRANSITION) {
+        pObs->status |= BOT_TRANSITION;
+    }
+}
+
+/**
+ * Simulate a single frame.
+ *
+ * @param  [out]pObs    The observation after the frame (may be NULL)
+ * @param  [ in]buttons Bit-mask of the pressed buttons (botButton for swordy,
+ *                      and botButton << BOT_GUNNY_SHIFT for gunny)
+ */
+err stepBot(botObservation *pObs, uint8_t buttons) {
+    int isLoadzone;
+    err erv;
+
+    ASSERT(bot.isInit, ERR_ARGUMENTBAD);
+
+    erv = _switchState();
+    ASSERT(erv == ERR_OK, erv);
+
+    _applyButtons(buttons);
+    game.elapsed = (int)((bot.frame + 1) * 1000 / BOT_FPS
+            - bot.frame * 1000 / BOT_FPS);
+
+    switch (game.currentState) {
+        case ST_PLAYSTATE: erv = simulatePlaystate(); break;
+        case ST_LEVELTRANSITION: erv = updateLeveltransition(); break;
+        default: erv = ERR_NOTIMPLEMENTED;
+    }
+    ASSERT(erv == ERR_OK, erv);
+    bot.frame++;
+
+    /* Respawning also plays a transition, but it's flagged as a checkpoint */
+    isLoadzone = (game.currentState == ST_PLAYSTATE
+            && game.nextState == ST_LEVELTRANSITION
+            && !(lvltransition.flags & LT_CHECKPOINT));
+
+    if (pObs) {
+        observeBot(pObs);
+        if (isLoadzone) {
+            pObs->status |= BOT_LOADZONE;
+        }
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Print an observation's summary, as "<frame> <status> <swordy's x> <swordy's
+ * y> <gunny's x> <gunny's y>".
+ *
+ * @param  [ in]pObs The observation
+ */
+static void _printObservation(botObservation *pObs) {
+    LOG("%u %x %i %i %i %i\n", (unsigned)pObs->frame, (unsigned)pObs->status
+            , (int)pObs->swordy.x, (int)pObs->swordy.y, (int)pObs->gunny.x
+            , (int)pObs->gunny.y);
+}
+
+/**
+ * Print the tiles around a player, a row per line.
+ *
+ * @param  [ in]pName   The player's name
+ * @param  [ in]pPlayer The player
+ */
+static void _printView(char *pName, botPlayer *pPlayer) {
+    int i, j;
+
+    LOG("%s\n", pName);
+    for (j = 0; j < BOT_VIEW_HEIGHT; j++) {
+        for (i = 0; i < BOT_VIEW_WIDTH; i++) {
+            LOG("%s%04x", (i == 0) ? "" : " "
+                    , (unsigned)pPlayer->pTiles[j][i]);
+        }
+        LOG("\n");
+    }
+}
+
+/**
+ * Run the bot from commands read from the standard input.
+ *
+ * @param  [ in]pLevel The first level
+ */
+err runBotCli(char *pLevel) {
+    char pLine[MAX_LEVEL_NAME + 16];
+    botObservation obs;
+    err erv;
+
+    erv = initBot();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    erv = resetBot(pLevel);
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+
+    observeBot(&obs);
+    _printObservation(&obs);
+    fflush(stdout);
+
+    while (fgets(pLine, sizeof(pLine), stdin) != 0) {
+        char pLevelName[MAX_LEVEL_NAME];
+        unsigned buttons;
+        int count, num;
+
+        num = sscanf(pLine, "%x %i", &buttons, &count);
+        if (strncmp(pLine, "quit", 4) == 0) {
+            break;
+        }
+        else if (strncmp(pLine, "view", 4) == 0) {
+            observeBot(&obs);
+            _printView("swordy", &obs.swordy);
+            _printView("gunny", &obs.gunny);
+        }
+        else if (strncmp(pLine, "reset", 5) == 0) {
+            /* Keep the current level, if none was supplied (note that the
+             * length is MAX_LEVEL_NAME - 1) */
+            if (sscanf(pLine + 5, "%127s", pLevelName) == 1) {
+                erv = resetBot(pLevelName);
+            }
+            else {
+                erv = resetBot(pLevels[bot.level].pName);
+            }
+            ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+
+            observeBot(&obs);
+            _printObservation(&obs);
+        }
+        else if (num >= 1) {
+            int isLoadzone = 0;
+
+            if (num != 2 || count < 1) {
+                count = 1;
+            }
+            /* Report a loadzone even if it was triggered mid-way */
+            while (count > 0) {
+                erv = stepBot(&obs, (uint8_t)buttons);
+                ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+                isLoadzone |= obs.status & BOT_LOADZONE;
+                count--;
+            }
+            obs.status |= isLoadzone;
+            _printObservation(&obs);
+        }
+        else {
+            LOG("?\n");
+        }
+        fflush(stdout);
+    }
+
+    erv = ERR_OK;
+__ret:
+    freeBot();
+
+    return erv;
+}
@@ -6,6 +6,8 @@
 
 #include <base/error.h>
 #include <base/game.h>
+#include <base/hash.h>
+#include <base/simulation.h>
 #include <conf/game.h>
 #include <jjat2/camera.h>
 #include <jjat2/entity.h>
@@ -23,7 +25,7 @@
 #define REST_TWEEN  ((MAX_TWEEN - MIN_TWEEN) / 2)
 
 /** Accumulate the current tween factor */
-static int _tween;
+static SIM_LOCAL int _tween;
 
 /** Enumerate all possible tween directions */
 enum enTweenDirection{
@@ -161,3 +163,32 @@ err updateCamera(entityCtx *pSwordy, entityCtx *pGunny) {
     return _centerCamera(pSwordy, pGunny, _tween);
 }
 
+/**
+ * Accumulate the camera's state (position and tween) into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashCamera(uint32_t hash) {
+    int x, y;
+
+    gfmCamera_getPosition(&x, &y, game.pCamera);
+    hash = hashInt(hash, x);
+    hash = hashInt(hash, y);
+    return hashInt(hash, _tween);
+}
+
+/** Retrieve the current tween factor between both characters */
+int getCameraTween() {
+    return _tween;
+}
+
+/**
+ * Overwrite the tween factor between both characters (e.g., when restoring a
+ * snapshot)
+ *
+ * @param  [ in]tween The tween factor
+ */
+void setCameraTween(int tween) {
+    _tween = tween;
+}
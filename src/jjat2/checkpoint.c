@@ -3,23 +3,20 @@
  */
 #include <base/error.h>
 #include <base/game.h>
+#include <base/simulation.h>
 #include <conf/state.h>
 #include <jjat2/checkpoint.h>
 #include <jjat2/leveltransition.h>
 #include <jjat2/playstate.h>
 #include <string.h>
 
-static char _stCheckpointName[MAX_VALID_LEN + 1];
-
 /**
  * Assign a new checkpoint, overwritting the previous one
  *
  * @param  [ in]pData Data for the level transition
  */
 err setCheckpoint(leveltransitionData *pData) {
-    checkpoint.data.pName = _stCheckpointName;
-
-    strcpy(checkpoint.data.pName, pData->pName);
+    checkpoint.data.level = pData->level;
     checkpoint.data.tgtX = pData->tgtX;
     checkpoint.data.tgtY = pData->tgtY;
 
@@ -9,8 +9,9 @@
 #include <conf/type.h>
 
 #include <jjat2/entity.h>
+#include <jjat2/enemies/g_walky.h>
 #include <jjat2/fx_group.h>
-#include <jjat2/hitbox.h>
+#include <jjat2/playstate.h>
 
 #include <GFraMe/gfmParser.h>
 #include <GFraMe/gfmSprite.h>
@@ -98,21 +99,6 @@ err initGreenWalky(entityCtx *pEnt, gfmParser *pParser) {
     rv = gfmSprite_setDirection(pEnt->pSelf, flip);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
-    /* Spawn an "eye-of-sight" */
-    if (flip) {
-        /* Facing left */
-        x = x + g_walky_width - g_walky_view_offx - g_walky_view_width;
-        y = y + g_walky_height - g_walky_view_offy - g_walky_view_height;
-    }
-    else {
-        /* Facing right */
-        x += g_walky_view_offx;
-        y += g_walky_view_offy;
-    }
-    pEnt->pSight = spawnFixedHitbox(pEnt, x, y, g_walky_view_width
-            , g_walky_view_height, T_EN_G_WALKY_VIEW);
-    ASSERT(pEnt->pSight, ERR_GFMERR);
-
     /* Play its default animation */
     pEnt->maxAnimation = G_WALKY_ANIM_COUNT;
     erv = setEntityAnimation(pEnt, STAND, 1/*force*/);
@@ -134,7 +120,6 @@ err initGreenWalky(entityCtx *pEnt, gfmParser *pParser) {
 err preUpdateGreenWalky(entityCtx *pEnt) {
     gfmRV rv;
     err erv;
-    int flip, x, y;
 
     if (pEnt->flags & EF_DEACTIVATE) {
         return ERR_OK;
@@ -146,20 +131,6 @@ err preUpdateGreenWalky(entityCtx *pEnt) {
         ASSERT(rv == GFMRV_OK, ERR_GFMERR);
     }
 
-    gfmSprite_getDirection(&flip, pEnt->pSelf);
-    gfmSprite_getPosition(&x, &y, pEnt->pSelf);
-    if (flip) {
-        /* Facing left */
-        x = x + g_walky_width - g_walky_view_offx - g_walky_view_width;
-        y = y + g_walky_height - g_walky_view_offy - g_walky_view_height;
-    }
-    else {
-        /* Facing right */
-        x += g_walky_view_offx;
-        y += g_walky_view_offy;
-    }
-    gfmObject_setPosition((gfmObject*)pEnt->pSight, x, y);
-
     /* Collide only if still alive */
     if (!(pEnt->flags & EF_ALIVE)) {
         pEnt->flags |= EF_SKIP_COLLISION;
@@ -229,6 +200,70 @@ err preUpdateGreenWalky(entityCtx *pEnt) {
     return ERR_OK;
 }
 
+/**
+ * Check whether an entity is within g_walky's "eye-of-sight"
+ *
+ * @param  [ in]pTarget The entity
+ * @param  [ in]x       The eye-of-sight's position
+ * @param  [ in]y       The eye-of-sight's position
+ */
+static int _isOnSight(entityCtx *pTarget, int x, int y) {
+    int h, tx, ty, w;
+
+    if ((pTarget->flags & (EF_ALIVE | EF_DEACTIVATE | EF_SKIP_COLLISION))
+            != EF_ALIVE) {
+        /* Avoid triggering for dead/just hit entity */
+        return 0;
+    }
+
+    gfmSprite_getPosition(&tx, &ty, pTarget->pSelf);
+    gfmSprite_getDimensions(&w, &h, pTarget->pSelf);
+
+    return tx < x + g_walky_view_width && x < tx + w
+            && ty < y + g_walky_view_height && y < ty + h;
+}
+
+/**
+ * Trigger g_walky's attack if any entity is within its "eye-of-sight". Since
+ * the sight only looks for entities, it's checked directly against them
+ * (instead of being a hitbox on the quadtree).
+ *
+ * @param  [ in]pEnt The enemy
+ */
+static void _lookForEntities(entityCtx *pEnt) {
+    int flip, i, x, y;
+
+    gfmSprite_getDirection(&flip, pEnt->pSelf);
+    gfmSprite_getPosition(&x, &y, pEnt->pSelf);
+    if (flip) {
+        /* Facing left */
+        x = x + g_walky_width - g_walky_view_offx - g_walky_view_width;
+        y = y + g_walky_height - g_walky_view_offy - g_walky_view_height;
+    }
+    else {
+        /* Facing right */
+        x += g_walky_view_offx;
+        y += g_walky_view_offy;
+    }
+
+    /* The inactive player (if any) isn't an entity on this frame */
+    if (((game.flags & AC_SWORDY) && _isOnSight(&playstate.swordy, x, y))
+            || ((game.flags & AC_GUNNY) && _isOnSight(&playstate.gunny, x, y))) {
+        triggerGreenWalkyAttack(pEnt);
+        return;
+    }
+
+    for (i = 0; i < playstate.entityCount; i++) {
+        entityCtx *pTarget = &playstate.entities[i];
+
+        if (pTarget != pEnt && pTarget->baseType == T_ENEMY
+                && _isOnSight(pTarget, x, y)) {
+            triggerGreenWalkyAttack(pEnt);
+            return;
+        }
+    }
+}
+
 /**
  * Set g_walky's animation and fix its entity's collision.
  *
@@ -241,6 +276,10 @@ err postUpdateGreenWalky(entityCtx *pEnt) {
         return ERR_OK;
     }
 
+    if (pEnt->flags & EF_ALIVE) {
+        _lookForEntities(pEnt);
+    }
+
     erv = postUpdateEntity(pEnt);
     ASSERT(erv == ERR_OK, erv);
     setEntityDirection(pEnt);
@@ -7,17 +7,63 @@
 #include <base/error.h>
 #include <base/game.h>
 #include <base/gfx.h>
+#include <base/hash.h>
 #include <base/input.h>
+#include <base/simulation.h>
+#if defined(JJAT_FIXED_PHYSICS)
+#  include <base/fixed.h>
+#endif /* JJAT_FIXED_PHYSICS */
 
 #include <conf/type.h>
 
 #include <jjat2/entity.h>
+#include <jjat2/floorspan.h>
 #include <jjat2/playstate.h>
+#include <jjat2/tilequery.h>
 
 #include <GFraMe/gfmError.h>
 #include <GFraMe/gfmInput.h>
 #include <GFraMe/gfmSprite.h>
 
+#include <stdint.h>
+
+#if defined(JJAT_FIXED_PHYSICS)
+/** How much faster a carried entity falls than its carrier (1.06125, in fixed
+ * point) */
+#  define CARRY_FALL_FACTOR 69550
+#endif /* JJAT_FIXED_PHYSICS */
+
+/** Maximum number of carried entities on a single frame (every entity and both
+ * players) */
+#define MAX_CARRY_NODES (MAX_ENTITIES + 2)
+
+/** Depth of a node still not sorted */
+#define CARRY_UNSORTED  0xff
+/** Depth of a node being sorted (i.e., reached while walking down a stack) */
+#define CARRY_SORTING   0xfe
+/** Depth of a node that isn't carried anymore (e.g., its link closed a cycle) */
+#define CARRY_FREE      0xfd
+
+/**
+ * Carry graph built while colliding the entities. Each node is a carried entity
+ * and its only edge is the entity's pCarrying, so the graph is a forest of
+ * stacks (if no cycle was found).
+ */
+struct stCarryGraph {
+    /** Every entity carried on this frame, in the order they were linked */
+    entityCtx *pNodes[MAX_CARRY_NODES];
+    /** Links from the bottom-most node (0) to the node, on its stack */
+    uint8_t pDepth[MAX_CARRY_NODES];
+    /** Nodes in the order they must be resolved */
+    uint8_t pOrder[MAX_CARRY_NODES];
+    /** Number of nodes */
+    uint8_t count;
+};
+typedef struct stCarryGraph carryGraph;
+
+/** The current frame's carry graph */
+static SIM_LOCAL carryGraph _carry;
+
 /**
  * Initialize the entity based on the previously set attributes
  *
@@ -26,6 +72,11 @@
 void initEntity(entityCtx *entity) {
     gfmSprite_setVerticalAcceleration(entity->pSelf, entity->standGravity);
     entity->flags = EF_ALIVE;
+    entity->floorSpan = -1;
+#if defined(JJAT_FIXED_PHYSICS)
+    entity->fx = 0;
+    entity->fy = 0;
+#endif /* JJAT_FIXED_PHYSICS */
 }
 
 /**
@@ -180,26 +231,204 @@ err collideEntity(entityCtx *entity) {
 }
 
 /**
- * Handle fixing an entity's position based on its carrier
+ * Retrieve the node of a carried entity. The index stored on the entity is only
+ * valid if it points back to the entity on the current graph, so the graph
+ * doesn't have to reset it on every entity when it's cleared.
+ *
+ * @param  [ in]entity The entity
+ * @return             The node's index, or -1 if not carried
+ */
+static int _findCarryNode(entityCtx *entity) {
+    if (entity->carryNode < _carry.count
+            && _carry.pNodes[entity->carryNode] == entity) {
+        return entity->carryNode;
+    }
+
+    return -1;
+}
+
+/**
+ * Add a carried entity to the current frame's carry graph. Its carrier is only
+ * read when the graph gets resolved, so an entity relinked to another carrier
+ * is still listed only once.
+ *
+ * @param  [ in]entity The carried entity
+ */
+static void _linkCarryNode(entityCtx *entity) {
+    if (_findCarryNode(entity) != -1 || _carry.count >= MAX_CARRY_NODES) {
+        return;
+    }
+
+    _carry.pNodes[_carry.count] = entity;
+    entity->carryNode = _carry.count;
+    _carry.count++;
+}
+
+/**
+ * Calculate the depth of a node (and of every unsorted node below it). Since
+ * each node is carried by a single entity, this simply walks down its stack.
+ *
+ * If the walk reaches a node being sorted, the stack loops into itself. The
+ * last link is then cut, so the node that closed the cycle stands on its own.
+ *
+ * @param  [ in]idx The node
+ */
+static void _sortCarryNode(int idx) {
+    uint8_t pPath[MAX_CARRY_NODES];
+    int cur, depth, len;
+
+    len = 0;
+    cur = idx;
+    while (cur != -1 && _carry.pDepth[cur] == CARRY_UNSORTED) {
+        _carry.pDepth[cur] = CARRY_SORTING;
+        pPath[len] = (uint8_t)cur;
+        len++;
+
+        if (_carry.pNodes[cur]->pCarrying == 0) {
+            /* Its link was reset after it was listed */
+            break;
+        }
+        cur = _findCarryNode(_carry.pNodes[cur]->pCarrying);
+    }
+
+    if (cur == -1) {
+        /* Reached the bottom of the stack */
+        depth = -1;
+    }
+    else if (_carry.pDepth[cur] == CARRY_SORTING) {
+        /* Either a cycle or a node whose link was reset */
+        len--;
+        _carry.pNodes[pPath[len]]->pCarrying = 0;
+        _carry.pDepth[pPath[len]] = CARRY_FREE;
+        depth = -1;
+    }
+    else if (_carry.pDepth[cur] == CARRY_FREE) {
+        depth = -1;
+    }
+    else {
+        depth = _carry.pDepth[cur];
+    }
+
+    /* Unwind the path, from the bottom-most node */
+    while (len > 0) {
+        len--;
+        depth++;
+        _carry.pDepth[pPath[len]] = (uint8_t)depth;
+    }
+}
+
+/**
+ * Sort every node so carriers are resolved before the entities they carry.
+ *
+ * @return The number of nodes to be resolved
+ */
+static int _sortCarryGraph() {
+    int count, depth, i, maxDepth;
+
+    for (i = 0; i < _carry.count; i++) {
+        _carry.pDepth[i] = CARRY_UNSORTED;
+    }
+
+    maxDepth = -1;
+    for (i = 0; i < _carry.count; i++) {
+        if (_carry.pDepth[i] == CARRY_UNSORTED) {
+            _sortCarryNode(i);
+        }
+        if (_carry.pDepth[i] != CARRY_FREE && _carry.pDepth[i] > maxDepth) {
+            maxDepth = _carry.pDepth[i];
+        }
+    }
+
+    /* Nodes on the same depth are kept in the order they were linked */
+    count = 0;
+    for (depth = 0; depth <= maxDepth; depth++) {
+        for (i = 0; i < _carry.count; i++) {
+            if (_carry.pDepth[i] == depth) {
+                _carry.pOrder[count] = (uint8_t)i;
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+#if defined(JJAT_FIXED_PHYSICS)
+/** Retrieve the time elapsed on the current frame, in seconds */
+static fixed _getElapsedFixed() {
+    return (fixed)(((int64_t)game.elapsed * FIXED_ONE) / 1000);
+}
+
+/**
+ * Integrate the entity's physics on fixed point.
+ *
+ * The velocity and the acceleration are still kept on the sprite (so every
+ * other module may keep accessing them), but they are only ever set to values
+ * that fit exactly in fixed point. The position is kept with sub-pixel
+ * precision on the entity itself and only its integer part is set on the
+ * sprite.
+ *
+ * @param  [ in]entity The entity
+ */
+static err _updateFixed(entityCtx *entity) {
+    double ax, ay, vx, vy;
+    fixed dt, fax, fay, fvx, fvy;
+    gfmRV rv;
+    int x, y;
+
+    /* If something else moved the sprite (e.g., the collision or a teleport),
+     * its sub-pixel position is lost */
+    gfmSprite_getPosition(&x, &y, entity->pSelf);
+    if (fixedToInt(entity->fx) != x) {
+        entity->fx = FIXED_FROM_INT(x);
+    }
+    if (fixedToInt(entity->fy) != y) {
+        entity->fy = FIXED_FROM_INT(y);
+    }
+
+    gfmSprite_getVelocity(&vx, &vy, entity->pSelf);
+    gfmSprite_getAcceleration(&ax, &ay, entity->pSelf);
+    fvx = fixedFromDouble(vx);
+    fvy = fixedFromDouble(vy);
+    fax = fixedFromDouble(ax);
+    fay = fixedFromDouble(ay);
+
+    dt = _getElapsedFixed();
+    fvx += fixedMul(fax, dt);
+    fvy += fixedMul(fay, dt);
+    entity->fx += fixedMul(fvx, dt);
+    entity->fy += fixedMul(fvy, dt);
+
+    /* Let GFraMe update everything else (e.g., the animation and the previous
+     * position, used by the collision) without moving the sprite */
+    gfmSprite_setVelocity(entity->pSelf, 0, 0);
+    gfmSprite_setAcceleration(entity->pSelf, 0, 0);
+    rv = gfmSprite_update(entity->pSelf, game.pCtx);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+
+    gfmSprite_setPosition(entity->pSelf, fixedToInt(entity->fx)
+            , fixedToInt(entity->fy));
+    gfmSprite_setVelocity(entity->pSelf, fixedToDouble(fvx)
+            , fixedToDouble(fvy));
+    gfmSprite_setAcceleration(entity->pSelf, fixedToDouble(fax)
+            , fixedToDouble(fay));
+
+    return ERR_OK;
+}
+#endif /* JJAT_FIXED_PHYSICS */
+
+/**
+ * Fix an entity's position based on its carrier. The carrier must have already
+ * been resolved.
  *
  * @param  [ in]entity   The entity
  */
-static err handleCarrying(entityCtx *entity) {
+static err _carryEntity(entityCtx *entity) {
     gfmSprite *pCarrierSpr;
     double vy;
     err erv;
     gfmRV rv;
 
-    /* Ensure the bottom-most entity and handled first. This makes horizontal
-     * movement be correctly propagated through the entities */
-    if (!entity->pCarrying || (entity->flags & EF_HAS_CARRIER)) {
-        return ERR_OK;
-    }
-    else if (entity->pCarrying->pCarrying) {
-        erv = handleCarrying(entity->pCarrying);
-        ASSERT(erv == ERR_OK, erv);
-    }
-
     pCarrierSpr = entity->pCarrying->pSelf;
 
     /* Get the collision flags as this started, update the entity's position and
@@ -220,7 +449,12 @@ static err handleCarrying(entityCtx *entity) {
     if (vy >= TILES_TO_PX(2)) {
         double ay;
         gfmSprite_getVerticalAcceleration(&ay, pCarrierSpr);
+#if defined(JJAT_FIXED_PHYSICS)
+        vy = fixedToDouble(fixedMul(CARRY_FALL_FACTOR, fixedFromDouble(vy)
+                + fixedMul(fixedFromDouble(ay), _getElapsedFixed())));
+#else /* !JJAT_FIXED_PHYSICS */
         vy = 1.06125 * (vy + ay * (game.elapsed * 0.001));
+#endif /* JJAT_FIXED_PHYSICS */
     }
     else if (vy >= -TILES_TO_PX(5)) {
         vy = TILES_TO_PX(5);
@@ -252,6 +486,110 @@ static err handleCarrying(entityCtx *entity) {
     return ERR_OK;
 }
 
+/** Start a new carry graph. Must be called before colliding any entity. */
+void clearCarryGraph() {
+    _carry.count = 0;
+}
+
+/**
+ * Fix the position of every entity being carried, from the bottom of each stack
+ * to its top, so horizontal movement is correctly propagated through the
+ * stack. Cycles (e.g., two entities landing on each other on the same frame)
+ * are broken by ignoring one of the links.
+ */
+err resolveCarryGraph() {
+    int count, i;
+    err erv;
+
+    count = _sortCarryGraph();
+    for (i = 0; i < count; i++) {
+        erv = _carryEntity(_carry.pNodes[_carry.pOrder[i]]);
+        ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    }
+
+    erv = ERR_OK;
+__ret:
+    _carry.count = 0;
+
+    return erv;
+}
+
+/**
+ * Retrieve the tile that contains a position.
+ *
+ * @param  [ in]px The position, in pixels
+ * @return         The tile (rounded down, even for negative positions)
+ */
+static int _getTile(int px) {
+    if (px >= 0) {
+        return px / TILE_DIMENSION;
+    }
+    return (px + 1) / TILE_DIMENSION - 1;
+}
+
+/**
+ * Ensure an entity didn't go through a floor on a long frame (i.e., when the
+ * game runs at a low FPS, see --FPS), when it may move farther than a tile plus
+ * its own dimensions.
+ *
+ * Every move that changes the tiles under the box is swept against the solid
+ * tiles. The entity is only moved if it ended completely past the first one it
+ * touched: it's then put back just slightly into that tile, only along the axis
+ * it entered through, so the regular collision separates it towards the
+ * correct side (with the usual flags). Any other overlap is left to the regular
+ * collision.
+ *
+ * Teleports aren't swept: they're discontinuous on purpose and get fixed as
+ * soon as they happen (see CF_FIXTELEPORT), so the position before the update
+ * is already the teleported one.
+ *
+ * @param  [ in]entity The entity
+ * @param  [ in]lastX  The entity's position before being updated
+ * @param  [ in]lastY  The entity's position before being updated
+ */
+static void _preventTunneling(entityCtx *entity, int lastX, int lastY) {
+    tileHit hit;
+    int dx, dy, h, tx, ty, w, x, y;
+
+    gfmSprite_getPosition(&x, &y, entity->pSelf);
+    gfmSprite_getDimensions(&w, &h, entity->pSelf);
+    if (_getTile(x) == _getTile(lastX) && _getTile(y) == _getTile(lastY)
+            && _getTile(x + w - 1) == _getTile(lastX + w - 1)
+            && _getTile(y + h - 1) == _getTile(lastY + h - 1)) {
+        return;
+    }
+
+    dx = x - lastX;
+    dy = y - lastY;
+    if (!sweepTiles(&hit, lastX, lastY, w, h, dx, dy, TQ_SOLID)) {
+        return;
+    }
+
+    /* Check if the tile is still overlapped */
+    tx = hit.tileX * TILE_DIMENSION;
+    ty = hit.tileY * TILE_DIMENSION;
+    if (x < tx + TILE_DIMENSION && tx < x + w && y < ty + TILE_DIMENSION
+            && ty < y + h) {
+        return;
+    }
+
+    if (hit.vertical) {
+        y = hit.y + ((dy > 0) ? 1 : -1);
+    }
+    else {
+        x = hit.x + ((dx > 0) ? 1 : -1);
+    }
+    gfmSprite_setPosition(entity->pSelf, x, y);
+#if defined(JJAT_FIXED_PHYSICS)
+    if (hit.vertical) {
+        entity->fy = FIXED_FROM_INT(y);
+    }
+    else {
+        entity->fx = FIXED_FROM_INT(x);
+    }
+#endif /* JJAT_FIXED_PHYSICS */
+}
+
 /**
  * Finalize updating the entity's physics
  *
@@ -261,6 +599,7 @@ err preUpdateEntity(entityCtx *entity) {
     double vy;
     gfmRV rv;
     err erv;
+    int x, y;
 
     entity->flags &= ~(EF_HAS_CARRIER);
     entity->pCarrying = 0;
@@ -281,8 +620,17 @@ err preUpdateEntity(entityCtx *entity) {
         gfmSprite_setVerticalVelocity(entity->pSelf, MAX_FALL_SPEED);
     }
 
+    gfmSprite_getPosition(&x, &y, entity->pSelf);
+#if defined(JJAT_FIXED_PHYSICS)
+    erv = _updateFixed(entity);
+    ASSERT(erv == ERR_OK, erv);
+#else /* !JJAT_FIXED_PHYSICS */
     rv = gfmSprite_update(entity->pSelf, game.pCtx);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+#endif /* JJAT_FIXED_PHYSICS */
+    if (!(entity->flags & EF_SKIP_COLLISION)) {
+        _preventTunneling(entity, x, y);
+    }
     erv = collideEntity(entity);
     ASSERT(erv == ERR_OK, erv);
 
@@ -292,18 +640,12 @@ err preUpdateEntity(entityCtx *entity) {
 /**
  * Post update an entity
  *
- * During this stage, the entity fixes its collision against the world and any
- * carrying sprite.
+ * The entity's position was already fixed against its carrier (if any) by
+ * resolveCarryGraph, so this is only kept as the common post-update step.
  *
  * @param  [ in]entity   The entity
  */
 err postUpdateEntity(entityCtx *entity) {
-    /* If the entity is being carried, collide against every static object and
-     * then adjust its velocity */
-    if (entity->pCarrying) {
-        return handleCarrying(entity);
-    }
-
     return ERR_OK;
 }
 
@@ -397,7 +739,7 @@ void setEntityDirection(entityCtx *entity) {
  * Simple collision check between two entities
  *
  * If this function detects collision, it ensures one entity will be carried by
- * the other, and only that.
+ * the other, and only that. The carried entity is added to the carry graph.
  *
  * @param  [ in]entA One of the entities
  * @param  [ in]entB The other entity
@@ -416,10 +758,12 @@ void collideTwoEntities(entityCtx *entA, entityCtx *entB) {
         if (adir & gfmCollision_down) {
             /* entA is above entB */
             entA->pCarrying = entB;
+            _linkCarryNode(entA);
         }
         else if (bdir & gfmCollision_down) {
             /* entB is above entA */
             entB->pCarrying = entA;
+            _linkCarryNode(entB);
         }
     }
 }
@@ -451,8 +795,7 @@ void killEntity(entityCtx *entity) {
  * @param  [ in]vx     The entity's velocity
  */
 void flipEntityOnEdge(entityCtx *entity, double vx) {
-    gfmRV rv;
-    int dir, h, type, w, x, y;
+    int dir, h, w, x, y;
 
     gfmSprite_getDimensions(&w, &h, entity->pSelf);
     gfmSprite_getDirection(&dir, entity->pSelf);
@@ -465,8 +808,10 @@ void flipEntityOnEdge(entityCtx *entity, double vx) {
         x += w + 1;
     }
 
-    rv = gfmTilemap_getTypeAt(&type, playstate.pMap, x, y);
-    if (rv == GFMRV_TILEMAP_NO_TILETYPE) {
+    /* Edges are simply the ends of the span below the entity (and the map's
+     * left border, which would otherwise get rounded into the first tile) */
+    if (x < 0 || !isOnFloorSpan(&entity->floorSpan, x / TILE_DIMENSION
+            , y / TILE_DIMENSION)) {
         if (dir == DIR_LEFT) {
             /* Flip to move right */
             gfmSprite_setHorizontalVelocity(entity->pSelf, vx);
@@ -486,3 +831,53 @@ void flipEntityOnEdge(entityCtx *entity, double vx) {
         }
     }
 }
+
+/**
+ * Retrieve a sprite's state (position, velocity, acceleration, direction and
+ * frame)
+ *
+ * @param  [out]pState The sprite's state
+ * @param  [ in]pSpr   The sprite
+ */
+void getSpriteState(spriteState *pState, gfmSprite *pSpr) {
+    gfmSprite_getPosition(&pState->x, &pState->y, pSpr);
+    gfmSprite_getVelocity(&pState->vx, &pState->vy, pSpr);
+    gfmSprite_getAcceleration(&pState->ax, &pState->ay, pSpr);
+    gfmSprite_getDirection(&pState->dir, pSpr);
+    gfmSprite_getFrame(&pState->frame, pSpr);
+}
+
+/**
+ * Restore a sprite's state. Its animation must already be playing (see
+ * setEntityAnimation), as this only displays the stored frame over it.
+ *
+ * @param  [ in]pSpr   The sprite
+ * @param  [ in]pState The sprite's state
+ */
+err setSpriteState(gfmSprite *pSpr, spriteState *pState) {
+    gfmRV rv;
+
+    gfmSprite_setPosition(pSpr, pState->x, pState->y);
+    gfmSprite_setVelocity(pSpr, pState->vx, pState->vy);
+    gfmSprite_setAcceleration(pSpr, pState->ax, pState->ay);
+    gfmSprite_setDirection(pSpr, pState->dir);
+
+    rv = gfmSprite_setFrame(pSpr, pState->frame);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+
+    return ERR_OK;
+}
+
+/**
+ * Accumulate a sprite's displayed frame into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @param  [ in]pSpr The sprite
+ * @return           The updated hash
+ */
+uint32_t hashSpriteAnimation(uint32_t hash, gfmSprite *pSpr) {
+    int frame;
+
+    gfmSprite_getFrame(&frame, pSpr);
+    return hashInt(hash, frame);
+}
@@ -11,28 +11,12 @@
 
 #include <jjat2/event.h>
 #include <jjat2/entity.h>
-#include <jjat2/events/common.h>
 #include <jjat2/events/door.h>
 #include <jjat2/events/pressurepad.h>
 
 #include <GFraMe/gfmSprite.h>
 #include <GFraMe/gfmParser.h>
 
-#include <stdint.h>
-#include <string.h>
-
-/** Local variables that events may modify/check */
-uint32_t _localVars;
-
-/**
- * Clear the local variables common to all events.
- *
- * These variables are "local" because they should get cleared on screen
- * transition.
- */
-void clearLocalVariables() {
-    _localVars = 0;
-}
 
 /**
  * Parse an event into the entity
@@ -129,6 +113,30 @@ err postUpdateEvent(entityCtx *pEnt) {
     return ERR_OK;
 }
 
+/**
+ * Notify an event that any of the signals it subscribed to changed
+ *
+ * @param  [ in]pEnt    The entity
+ */
+err notifyEvent(entityCtx *pEnt) {
+    void *pChild;
+    int type;
+    gfmRV rv;
+
+    rv = gfmSprite_getChild(&pChild, &type, pEnt->pSelf);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+
+    switch (type) {
+        case T_DOOR:
+        case T_HDOOR: {
+            onDoorSignal(pEnt);
+        } break;
+        default: {}
+    }
+
+    return ERR_OK;
+}
+
 /**
  * Draw an event
  *
@@ -156,25 +164,3 @@ err drawEvent(entityCtx *pEnt) {
 
     return ERR_OK;
 }
-
-/**
- * Convert a local variable into its value
- *
- * @param  [ in]pVal The value
- * @return The variable's value or 0, on failure
- */
-uint8_t _getLocalVar(char *pVal) {
-#define TEST(val) \
-    if (memcmp(pVal, #val , 2) == 0) { \
-        return EV_LOCAL_ ## val; \
-    } \
-
-    TEST(A)
-    else TEST(B)
-    else TEST(C)
-    else TEST(D)
-    else TEST(E)
-
-    return 0;
-}
-
@@ -6,8 +6,8 @@
 #include <base/game.h>
 #include <base/gfx.h>
 #include <conf/type.h>
-#include <jjat2/events/common.h>
 #include <jjat2/events/door.h>
+#include <jjat2/events/signal.h>
 #include <jjat2/entity.h>
 #include <jjat2/hitbox.h>
 #include <GFraMe/gfmParser.h>
@@ -25,6 +25,10 @@
 #define door_f4_height1 6
 #define door_f5_height  2
 
+/** Set whenever the door's signals change, and kept until the door settles on
+ * the state they select */
+#define DOOR_PENDING    (0x01 << EV_SIGNAL_SHIFT)
+
 enum enDoorFrames {
     f0 = 313
   , f1 = 314
@@ -97,7 +101,7 @@ err initDoor(entityCtx *pEnt, gfmParser *pParser, int isVertical) {
     err erv;
     int i, l, x, y;
     uint8_t anim;
-    uint8_t lock;
+    uint32_t lock;
 
     rv = gfmParser_getNumProperties(&l, pParser);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
@@ -120,7 +124,11 @@ err initDoor(entityCtx *pEnt, gfmParser *pParser, int isVertical) {
             }
         }
         else if (memcmp(pKey, "lock_", 5) == 0) {
-            lock |= _getLocalVar(pVal);
+            uint32_t signal;
+
+            erv = getSignal(&signal, pVal);
+            ASSERT(erv == ERR_OK, erv);
+            lock |= signal;
         }
 
         i++;
@@ -165,6 +173,9 @@ err initDoor(entityCtx *pEnt, gfmParser *pParser, int isVertical) {
     /* Store the door's lock on the entity's flags */
     pEnt->flags = lock;
 
+    erv = subscribeSignals(pEnt, lock);
+    ASSERT(erv == ERR_OK, erv);
+
     return ERR_OK;
 }
 
@@ -261,22 +272,37 @@ err preUpdateDoor(entityCtx *pEnt) {
     }
 
     if (pBox1 != 0) {
-        gfmHitbox_setHitFlag(pBox1, side);
+        setHitboxFlag(pBox1, side);
     }
     if (pBox2 != 0) {
-        gfmHitbox_setHitFlag(pBox2, side);
+        setHitboxFlag(pBox2, side);
     }
 
     return ERR_OK;
 }
 
 /**
- * Change the door's animation depending on the local variables
+ * Mark the door to be updated, as its signals changed
+ *
+ * @param  [ in]pEnt    The entity
+ */
+void onDoorSignal(entityCtx *pEnt) {
+    pEnt->flags |= DOOR_PENDING;
+}
+
+/**
+ * Change the door's animation depending on its signals
  *
  * @param  [ in]pEnt    The entity
  */
 err postUpdateDoor(entityCtx *pEnt) {
     gfmRV rv;
+    int isUnlocked;
+
+    if (!(pEnt->flags & DOOR_PENDING)) {
+        /* Nothing changed since the door last settled */
+        return ERR_OK;
+    }
 
     rv = gfmSprite_didAnimationFinish(pEnt->pSelf);
     if (rv == GFMRV_FALSE) {
@@ -293,24 +319,24 @@ err postUpdateDoor(entityCtx *pEnt) {
         default: { /* Does nothing */ }
     }
 
-    if ((pEnt->flags & _localVars) == pEnt->flags
-            && pEnt->currentAnimation == CLOSED) {
+    /* Keep DOOR_PENDING while animating, so the signals are checked once again
+     * as soon as the animation finishes */
+    isUnlocked = areSignalsRaised(pEnt->flags & EV_SIGNAL_MASK);
+    if (isUnlocked && pEnt->currentAnimation == CLOSED) {
         return setEntityAnimation(pEnt, OPENING, 0/*force*/);
     }
-    else if ((pEnt->flags & _localVars) != pEnt->flags
-            && pEnt->currentAnimation == OPEN) {
+    else if (!isUnlocked && pEnt->currentAnimation == OPEN) {
         return setEntityAnimation(pEnt, CLOSING, 0/*force*/);
     }
     /* Reverse doors (def: open, close on set) */
-    else if ((pEnt->flags & _localVars) == pEnt->flags
-            && pEnt->currentAnimation == ROPEN) {
+    else if (isUnlocked && pEnt->currentAnimation == ROPEN) {
         return setEntityAnimation(pEnt, RCLOSING, 0/*force*/);
     }
-    else if ((pEnt->flags & _localVars) != pEnt->flags
-            && pEnt->currentAnimation == RCLOSED) {
+    else if (!isUnlocked && pEnt->currentAnimation == RCLOSED) {
         return setEntityAnimation(pEnt, ROPENING, 0/*force*/);
     }
 
+    pEnt->flags &= ~DOOR_PENDING;
     return ERR_OK;
 }
 
@@ -5,8 +5,8 @@
 #include <base/game.h>
 #include <base/gfx.h>
 #include <conf/type.h>
-#include <jjat2/events/common.h>
 #include <jjat2/events/pressurepad.h>
+#include <jjat2/events/signal.h>
 #include <jjat2/entity.h>
 #include <GFraMe/gframe.h>
 #include <GFraMe/gfmSprite.h>
@@ -25,8 +25,9 @@ enum enPressurePadState {
     DISABLED    = 0x0
   , PRESSING    = 0x1
   , PRESSED     = 0x2
-  , STATE_MASK  = (0x03 << EV_LOCAL_SHIFT)
-  , DID_COLLIDE = (0x80 << EV_LOCAL_SHIFT)
+  , STATE_MASK  = (0x03 << EV_SIGNAL_SHIFT)
+  , IS_EMITTING = (0x40 << EV_SIGNAL_SHIFT)
+  , DID_COLLIDE = (0x80 << EV_SIGNAL_SHIFT)
 };
 
 /**
@@ -37,8 +38,9 @@ enum enPressurePadState {
  */
 err initPressurePad(entityCtx *pEnt, gfmParser *pParser) {
     gfmRV rv;
+    err erv;
     int i, l, x, y;
-    uint8_t lock;
+    uint32_t lock;
 
     rv = gfmParser_getNumProperties(&l, pParser);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
@@ -52,7 +54,11 @@ err initPressurePad(entityCtx *pEnt, gfmParser *pParser) {
         ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
         if (memcmp(pKey, "set_", 4) == 0) {
-            lock |= _getLocalVar(pVal);
+            uint32_t signal;
+
+            erv = getSignal(&signal, pVal);
+            ASSERT(erv == ERR_OK, erv);
+            lock |= signal;
         }
 
         i++;
@@ -89,9 +95,17 @@ err initPressurePad(entityCtx *pEnt, gfmParser *pParser) {
  */
 err postUpdatePressurePad(entityCtx *pEnt) {
     gfmRV rv;
+    err erv;
     uint32_t curState;
 
-    curState = (pEnt->flags & STATE_MASK) >> EV_LOCAL_SHIFT;
+    /* Stop emitting as soon as it's released */
+    if ((pEnt->flags & IS_EMITTING) && !(pEnt->flags & DID_COLLIDE)) {
+        pEnt->flags &= ~IS_EMITTING;
+        erv = lowerSignals(pEnt->flags & EV_SIGNAL_MASK);
+        ASSERT(erv == ERR_OK, erv);
+    }
+
+    curState = (pEnt->flags & STATE_MASK) >> EV_SIGNAL_SHIFT;
 
     /* Update the "animation" of the pressure pad */
     if ((pEnt->flags & DID_COLLIDE) && curState != PRESSED) {
@@ -110,7 +124,7 @@ err postUpdatePressurePad(entityCtx *pEnt) {
     }
 
     pEnt->flags = (pEnt->flags & ~STATE_MASK);
-    pEnt->flags |= curState << EV_LOCAL_SHIFT;
+    pEnt->flags |= curState << EV_SIGNAL_SHIFT;
     pEnt->flags &= ~DID_COLLIDE;
 
     return ERR_OK;
@@ -140,16 +154,23 @@ err drawPressurePad(entityCtx *pEnt) {
 }
 
 /**
- * Activate the pressure pad (and set any local var if fully pressed)
+ * Activate the pressure pad (and raise its signals if fully pressed)
  *
  * @param  [ in]pEnt    The entity
  */
-void pressPressurePad(entityCtx *pEnt) {
+err pressPressurePad(entityCtx *pEnt) {
+    err erv;
+
     pEnt->flags |= DID_COLLIDE;
 
-    /* Set the local var if pressed */
-    if ((pEnt->flags & STATE_MASK) >> EV_LOCAL_SHIFT == PRESSED) {
-        _localVars |= (pEnt->flags & EV_LOCAL_MASK);
+    /* Start emitting if pressed (and not emitting yet) */
+    if ((pEnt->flags & STATE_MASK) >> EV_SIGNAL_SHIFT == PRESSED
+            && !(pEnt->flags & IS_EMITTING)) {
+        pEnt->flags |= IS_EMITTING;
+        erv = raiseSignals(pEnt->flags & EV_SIGNAL_MASK);
+        ASSERT(erv == ERR_OK, erv);
     }
+
+    return ERR_OK;
 }
 
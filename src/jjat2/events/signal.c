@@ -0,0 +1,150 @@
+/**
+ * @file src/jjat2/events/signal.c
+ *
+ * Named signals that events publish and listen to.
+ */
+#include <base/error.h>
+
+#include <jjat2/event.h>
+#include <jjat2/events/signal.h>
+#include <jjat2/playstate.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/** Remove every signal (and subscriber), before loading a level */
+void resetSignals() {
+    memset(&signalBus, 0x0, sizeof(signalBusCtx));
+}
+
+/**
+ * Retrieve a signal by its name, registering it if not used yet.
+ *
+ * @param  [out]pMask  Bitmask with only the signal set
+ * @param  [ in]pName  The signal's name
+ */
+err getSignal(uint32_t *pMask, char *pName) {
+    int i;
+
+    ASSERT(pName[0] != '\0' && strlen(pName) < MAX_SIGNAL_NAME
+            , ERR_PARSINGERR);
+
+    for (i = 0; i < signalBus.count; i++) {
+        if (strcmp(signalBus.pNames[i], pName) == 0) {
+            *pMask = 1 << i;
+            return ERR_OK;
+        }
+    }
+
+    ASSERT(signalBus.count < MAX_SIGNALS, ERR_BUFFERTOOSMALL);
+    strcpy(signalBus.pNames[signalBus.count], pName);
+    *pMask = 1 << signalBus.count;
+    signalBus.count++;
+
+    return ERR_OK;
+}
+
+/**
+ * Notify an event whenever any of the signals changes.
+ *
+ * @param  [ in]pEnt The event (must be on playstate.entities)
+ * @param  [ in]mask Bitmask of signals
+ */
+err subscribeSignals(entityCtx *pEnt, uint32_t mask) {
+    int i, idx;
+
+    idx = (int)(pEnt - playstate.entities);
+    ASSERT(idx >= 0 && idx < MAX_ENTITIES, ERR_ARGUMENTBAD);
+
+    for (i = 0; i < signalBus.count; i++) {
+        if (mask & (1 << i)) {
+            signalBus.pSubscribers[i] |= (uint32_t)1 << idx;
+        }
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Notify every subscriber of a signal that it has changed.
+ *
+ * @param  [ in]signal The signal's index
+ */
+static err _notifySubscribers(int signal) {
+    uint32_t subscribers;
+    err erv;
+    int i;
+
+    subscribers = signalBus.pSubscribers[signal];
+    for (i = 0; subscribers != 0; i++, subscribers >>= 1) {
+        if (subscribers & 1) {
+            erv = notifyEvent(&playstate.entities[i]);
+            ASSERT(erv == ERR_OK, erv);
+        }
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Start emitting signals (notifying the subscribers of those that were
+ * lowered).
+ *
+ * @param  [ in]mask Bitmask of signals
+ */
+err raiseSignals(uint32_t mask) {
+    err erv;
+    int i;
+
+    for (i = 0; i < signalBus.count; i++) {
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+
+        signalBus.state.pEmitters[i]++;
+        if (signalBus.state.pEmitters[i] == 1) {
+            signalBus.state.raised |= 1 << i;
+            erv = _notifySubscribers(i);
+            ASSERT(erv == ERR_OK, erv);
+        }
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Stop emitting signals (notifying the subscribers of those that are no longer
+ * emitted by anyone).
+ *
+ * @param  [ in]mask Bitmask of signals
+ */
+err lowerSignals(uint32_t mask) {
+    err erv;
+    int i;
+
+    for (i = 0; i < signalBus.count; i++) {
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+
+        ASSERT(signalBus.state.pEmitters[i] > 0, ERR_UNEXPECTEDBEHAVIOUR);
+        signalBus.state.pEmitters[i]--;
+        if (signalBus.state.pEmitters[i] == 0) {
+            signalBus.state.raised &= ~(1 << i);
+            erv = _notifySubscribers(i);
+            ASSERT(erv == ERR_OK, erv);
+        }
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Check whether every signal is currently raised.
+ *
+ * @param  [ in]mask Bitmask of signals
+ * @return           1 if all of them are raised, 0 otherwise
+ */
+int areSignalsRaised(uint32_t mask) {
+    return (signalBus.state.raised & mask) == mask;
+}
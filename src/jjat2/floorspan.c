@@ -0,0 +1,171 @@
+/**
+ * @file src/jjat2/floorspan.c
+ *
+ * Horizontal runs of tiles (i.e., the platforms entities may walk on) found
+ * when a level is loaded.
+ */
+#include <base/error.h>
+
+#include <jjat2/floorspan.h>
+#include <jjat2/playstate.h>
+#include <jjat2/tilequery.h>
+
+#include <GFraMe/gfmError.h>
+#include <GFraMe/gfmTilemap.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Ensure there's room for another span.
+ */
+static err _growSpans() {
+    if (floorSpans.count >= floorSpans.spansLen) {
+        floorSpan *pSpans;
+        int len;
+
+        len = floorSpans.spansLen * 2;
+        if (len == 0) {
+            len = 64;
+        }
+
+        pSpans = realloc(floorSpans.pSpans, sizeof(floorSpan) * len);
+        ASSERT(pSpans, ERR_OOM);
+        floorSpans.pSpans = pSpans;
+        floorSpans.spansLen = len;
+    }
+
+    return ERR_OK;
+}
+
+/** Find every span on the currently loaded tilemap (playstate.pMap) */
+err buildFloorSpans() {
+    gfmRV rv;
+    err erv;
+    int height, width, x, y;
+
+    rv = gfmTilemap_getDimension(&width, &height, playstate.pMap);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    width /= TILE_DIMENSION;
+    height /= TILE_DIMENSION;
+
+    if (height + 1 > floorSpans.rowsLen) {
+        uint16_t *pRows;
+
+        pRows = realloc(floorSpans.pRows, sizeof(uint16_t) * (height + 1));
+        ASSERT(pRows, ERR_OOM);
+        floorSpans.pRows = pRows;
+        floorSpans.rowsLen = height + 1;
+    }
+
+    floorSpans.count = 0;
+    floorSpans.width = width;
+    floorSpans.height = height;
+
+    for (y = 0; y < height; y++) {
+        floorSpans.pRows[y] = (uint16_t)floorSpans.count;
+
+        x = 0;
+        while (x < width) {
+            floorSpan *pSpan;
+
+            if (getTileType(x, y) == 0) {
+                x++;
+                continue;
+            }
+
+            erv = _growSpans();
+            ASSERT(erv == ERR_OK, erv);
+
+            pSpan = &floorSpans.pSpans[floorSpans.count];
+            pSpan->row = (uint16_t)y;
+            pSpan->left = (uint16_t)x;
+            while (x < width && getTileType(x, y) != 0) {
+                x++;
+            }
+            pSpan->right = (uint16_t)(x - 1);
+
+            floorSpans.count++;
+        }
+    }
+    floorSpans.pRows[height] = (uint16_t)floorSpans.count;
+
+    return ERR_OK;
+}
+
+/** Release the spans */
+void freeFloorSpans() {
+    free(floorSpans.pSpans);
+    free(floorSpans.pRows);
+    memset(&floorSpans, 0x0, sizeof(floorSpansCtx));
+}
+
+/**
+ * Retrieve the span that contains a tile.
+ *
+ * @param  [ in]tileX The tile's position, in tiles
+ * @param  [ in]tileY The tile's position, in tiles
+ * @return            The span's index, or -1 if the tile isn't on any span
+ */
+int getFloorSpan(int tileX, int tileY) {
+    int first, last;
+
+    if (tileX < 0 || tileY < 0 || tileX >= floorSpans.width
+            || tileY >= floorSpans.height) {
+        return -1;
+    }
+
+    /* Binary search the row's spans */
+    first = floorSpans.pRows[tileY];
+    last = floorSpans.pRows[tileY + 1] - 1;
+    while (first <= last) {
+        floorSpan *pSpan;
+        int mid;
+
+        mid = (first + last) / 2;
+        pSpan = &floorSpans.pSpans[mid];
+        if (tileX < pSpan->left) {
+            last = mid - 1;
+        }
+        else if (tileX > pSpan->right) {
+            first = mid + 1;
+        }
+        else {
+            return mid;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Check whether there's a span on a tile, using (and updating) a cached span.
+ *
+ * @param  [ io]pCache The latest span found by the caller (-1 if none)
+ * @param  [ in]tileX  The tile's position, in tiles
+ * @param  [ in]tileY  The tile's position, in tiles
+ * @return             1 if the tile is on a span, 0 otherwise
+ */
+int isOnFloorSpan(int32_t *pCache, int tileX, int tileY) {
+    int idx;
+
+    idx = *pCache;
+    if (idx >= 0 && idx < floorSpans.count) {
+        floorSpan *pSpan = &floorSpans.pSpans[idx];
+
+        if (pSpan->row == tileY && pSpan->left <= tileX
+                && tileX <= pSpan->right) {
+            return 1;
+        }
+    }
+
+    idx = getFloorSpan(tileX, tileY);
+    if (idx == -1) {
+        /* Keep the cache, as the entity is most likely about to turn back */
+        return 0;
+    }
+    *pCache = (int32_t)idx;
+
+    return 1;
+}
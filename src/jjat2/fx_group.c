@@ -9,14 +9,20 @@
 #include <base/error.h>
 #include <base/game.h>
 #include <base/gfx.h>
+#include <base/hash.h>
+#include <base/simulation.h>
 
 #include <conf/type.h>
 
 #include <GFraMe/gfmGroup.h>
 #include <GFraMe/gfmSprite.h>
 
+#include <jjat2/entity.h>
 #include <jjat2/fx_group.h>
 
+#include <limits.h>
+#include <string.h>
+
 const int checkpointSavedDuration = 1000 / 15 * 9;
 
 static int pFxAnimData[] = {
@@ -32,6 +38,40 @@ static int pFxAnimData[] = {
 };
 static int fxAnimDataLen = sizeof(pFxAnimData) / sizeof(int);
 
+/** Deadline of effects spawned without a TTL */
+#define FX_NO_DEADLINE  INT_MAX
+
+/** An effect spawned by spawnFx, tracked until it dies (or is removed) */
+struct stFxSlot {
+    gfmSprite *pSpr;
+    gfmGroupNode *pNode;
+    /** When the effect dies (on _fxTime's scale). FX_NO_DEADLINE if it was
+     * spawned without a TTL */
+    int deadline;
+    int16_t w;
+    int16_t h;
+    int16_t t;
+    uint8_t anim;
+    uint8_t flipped;
+};
+typedef struct stFxSlot fxSlot;
+
+/** Time since the group was initialized, in milliseconds */
+static SIM_LOCAL int _fxTime;
+/** Every effect that may be alive. A slot is free if its deadline already
+ * passed. Since the group never holds more than MAX_FX_NUM effects, there's
+ * always a free slot on spawn */
+static SIM_LOCAL fxSlot _fxSlots[MAX_FX_NUM];
+
+/**
+ * Check whether a slot holds a live effect.
+ *
+ * @param  [ in]i The slot
+ */
+static inline int _isSlotAlive(int i) {
+    return _fxSlots[i].deadline > _fxTime;
+}
+
 /**
  * Spawn a new effect at the desired position
  *
@@ -48,7 +88,9 @@ static int fxAnimDataLen = sizeof(pFxAnimData) / sizeof(int);
 gfmSprite* spawnFx(int x, int y, int w, int h, int flipped, int ttl,
         fxAnim anim, type t) {
     gfmSprite *pSpr;
+    fxSlot *pSlot;
     gfmRV rv;
+    int i, tmp;
 
     /* Ugly hack: there's no way to modify a node's TTL... So modify the groups'
      * and then revert it back... */
@@ -62,6 +104,30 @@ gfmSprite* spawnFx(int x, int y, int w, int h, int flipped, int ttl,
     }
     ASSERT(rv == GFMRV_OK, 0);
 
+    /* The recycled sprite may belong to an effect whose TTL just expired (but
+     * whose slot wasn't released yet), so prefer reusing its slot */
+    pSlot = 0;
+    for (i = 0; i < MAX_FX_NUM; i++) {
+        if (_fxSlots[i].pSpr == pSpr) {
+            pSlot = &_fxSlots[i];
+            break;
+        }
+        else if (pSlot == 0 && !_isSlotAlive(i)) {
+            pSlot = &_fxSlots[i];
+        }
+    }
+    ASSERT(pSlot != 0, 0);
+
+    pSlot->pSpr = pSpr;
+    rv = gfmSprite_getChild((void**)&pSlot->pNode, &tmp, pSpr);
+    ASSERT(rv == GFMRV_OK, 0);
+    pSlot->deadline = (ttl > 0) ? _fxTime + ttl : FX_NO_DEADLINE;
+    pSlot->w = (int16_t)w;
+    pSlot->h = (int16_t)h;
+    pSlot->t = (int16_t)t;
+    pSlot->anim = (uint8_t)anim;
+    pSlot->flipped = (uint8_t)flipped;
+
     rv = gfmSprite_setPosition(pSpr, x, y);
     ASSERT(rv == GFMRV_OK, 0);
     rv = gfmSprite_setDimensions(pSpr, w, h);
@@ -124,6 +190,7 @@ err updateFxGroup() {
 
     rv = gfmGroup_update(fx, game.pCtx);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    _fxTime += game.elapsed;
 
     rv = gfmQuadtree_collideGroup(collision.pStaticQt, fx);
     if (rv == GFMRV_QUADTREE_OVERLAPED) {
@@ -143,3 +210,171 @@ err updateFxGroup() {
     return ERR_OK;
 }
 
+/** Remove every effect from the group */
+err killAllFx() {
+    gfmRV rv;
+
+    rv = gfmGroup_killAll(fx);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    memset(_fxSlots, 0x0, sizeof(_fxSlots));
+    _fxTime = 0;
+
+    return ERR_OK;
+}
+
+/**
+ * Remove an effect before it dies by itself
+ *
+ * @param  [ in]pNode The effect's node
+ */
+err removeFx(gfmGroupNode *pNode) {
+    gfmRV rv;
+    int i;
+
+    rv = gfmGroup_removeNode(pNode);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+
+    for (i = 0; i < MAX_FX_NUM; i++) {
+        if (_fxSlots[i].pNode == pNode && _isSlotAlive(i)) {
+            _fxSlots[i].deadline = 0;
+            break;
+        }
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Check whether any effect may still be alive (and, therefore, animating).
+ *
+ * Effects without a TTL may leave the screen without ever being removed, so
+ * this is conservative: it may report an effect that isn't visible anymore.
+ *
+ * @return 1 if idle, 0 otherwise
+ */
+int isFxGroupIdle() {
+    return getFxCount() == 0;
+}
+
+/**
+ * Count how many effects are alive. Just like isFxGroupIdle, effects without a
+ * TTL are counted until explicitly removed.
+ */
+int getFxCount() {
+    int i, count;
+
+    count = 0;
+    for (i = 0; i < MAX_FX_NUM; i++) {
+        if (_isSlotAlive(i)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Accumulate the state of every live effect into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashFx(uint32_t hash) {
+    uint32_t sum;
+    int i;
+
+    /* Restoring effects may place them on different slots, so each effect is
+     * hashed on its own and their order is ignored */
+    sum = 0;
+    for (i = 0; i < MAX_FX_NUM; i++) {
+        uint32_t fxHash;
+        int x, y;
+
+        if (!_isSlotAlive(i)) {
+            continue;
+        }
+
+        fxHash = HASH_INIT;
+        gfmSprite_getPosition(&x, &y, _fxSlots[i].pSpr);
+        if (_fxSlots[i].deadline != FX_NO_DEADLINE) {
+            fxHash = hashInt(fxHash, _fxSlots[i].deadline - _fxTime);
+        }
+        fxHash = hashInt(fxHash, x);
+        fxHash = hashInt(fxHash, y);
+        sum += hashSpriteAnimation(fxHash, _fxSlots[i].pSpr);
+    }
+
+    return hashInt(hash, sum);
+}
+
+/**
+ * Store the state of every live effect.
+ *
+ * @param  [out]pList  The effects' states
+ * @param  [ in]maxLen How many states fit on the list
+ * @param  [ in]pSkip  An effect that shouldn't be stored (may be NULL)
+ * @return             How many effects were stored
+ */
+int saveFx(fxState *pList, int maxLen, gfmGroupNode *pSkip) {
+    int i, len;
+
+    len = 0;
+    for (i = 0; i < MAX_FX_NUM && len < maxLen; i++) {
+        fxState *pState;
+        fxSlot *pSlot;
+
+        pSlot = &_fxSlots[i];
+        if (!_isSlotAlive(i) || pSlot->pNode == pSkip) {
+            continue;
+        }
+
+        pState = &pList[len];
+        getSpriteState(&pState->spr, pSlot->pSpr);
+        gfmSprite_getOffset(&pState->offx, &pState->offy, pSlot->pSpr);
+        if (pSlot->deadline == FX_NO_DEADLINE) {
+            pState->ttl = 0;
+        }
+        else {
+            pState->ttl = pSlot->deadline - _fxTime;
+        }
+        pState->w = pSlot->w;
+        pState->h = pSlot->h;
+        pState->t = pSlot->t;
+        pState->anim = pSlot->anim;
+        pState->flipped = pSlot->flipped;
+        len++;
+    }
+
+    return len;
+}
+
+/**
+ * Replace every effect with the previously stored ones. Animations are played
+ * again from their start, displaying the stored frame.
+ *
+ * @param  [ in]pList The effects' states
+ * @param  [ in]len   How many states there are on the list
+ */
+err restoreFx(fxState *pList, int len) {
+    err erv;
+    int i;
+
+    erv = killAllFx();
+    ASSERT(erv == ERR_OK, erv);
+
+    for (i = 0; i < len; i++) {
+        fxState *pState;
+        gfmSprite *pSpr;
+
+        pState = &pList[i];
+        pSpr = spawnFx(pState->spr.x, pState->spr.y, pState->w, pState->h
+                , pState->flipped, pState->ttl, (fxAnim)pState->anim
+                , (type)pState->t);
+        ASSERT(pSpr != 0, ERR_GFMERR);
+        erv = setSpriteState(pSpr, &pState->spr);
+        ASSERT(erv == ERR_OK, erv);
+        gfmSprite_setOffset(pSpr, pState->offx, pState->offy);
+    }
+
+    return ERR_OK;
+}
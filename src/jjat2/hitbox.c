@@ -6,6 +6,7 @@
  */
 #include <base/collision.h>
 #include <base/error.h>
+#include <base/hash.h>
 #include <GFraMe/gfmError.h>
 #include <GFraMe/gfmHitbox.h>
 #include <jjat2/hitbox.h>
@@ -52,6 +53,7 @@ void resetTmpHitboxes() {
  */
 static gfmHitbox* _spawnHitboxAt(void *pCtx, int x, int y, int width, int height
         , int type, int i) {
+    hitboxState *pState;
     gfmHitbox* pHitbox;
     gfmRV rv;
 
@@ -60,6 +62,16 @@ static gfmHitbox* _spawnHitboxAt(void *pCtx, int x, int y, int width, int height
     rv = gfmHitbox_getItem(&pHitbox, hitboxes.pList, i);
     ASSERT(rv == GFMRV_OK, 0);
 
+    pState = &hitboxes.states[i];
+    pState->pCtx = pCtx;
+    pState->pHitbox = pHitbox;
+    pState->x = x;
+    pState->y = y;
+    pState->width = width;
+    pState->height = height;
+    pState->type = type;
+    pState->hitFlag = -1;
+
     return pHitbox;
 }
 
@@ -108,6 +120,109 @@ gfmHitbox* spawnTmpHitbox(void *pCtx, int x, int y, int width, int height, int t
     return pHitbox;
 }
 
+/**
+ * Set which sides of a spawned hitbox collide.
+ *
+ * @param  [ in]pHitbox The hitbox
+ * @param  [ in]flag    The sides (a gfmCollision bitmask)
+ */
+void setHitboxFlag(gfmHitbox *pHitbox, int flag) {
+    int i;
+
+    gfmHitbox_setHitFlag(pHitbox, flag);
+
+    for (i = 0; i < MAX_HITBOXES; i++) {
+        if (hitboxes.states[i].pHitbox == pHitbox) {
+            hitboxes.states[i].hitFlag = flag;
+            break;
+        }
+    }
+}
+
+/**
+ * Spawn a hitbox exactly as it was stored.
+ *
+ * @param  [ in]pState How the hitbox was spawned
+ * @param  [ in]i      The index within the list
+ */
+static err _restoreHitboxAt(hitboxState *pState, int i) {
+    gfmHitbox *pHitbox;
+
+    pHitbox = _spawnHitboxAt(pState->pCtx, pState->x, pState->y
+            , pState->width, pState->height, pState->type, i);
+    ASSERT(pHitbox != 0, ERR_GFMERR);
+    if (pState->hitFlag != -1) {
+        setHitboxFlag(pHitbox, pState->hitFlag);
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Replace every hitbox with the previously stored ones (i.e., a copy of
+ * hitboxes.states and of its counters).
+ *
+ * @param  [ in]pList   How every hitbox was spawned
+ * @param  [ in]used    How many fixed hitboxes there are
+ * @param  [ in]tmpUsed How many transient hitboxes there are
+ */
+err restoreHitboxes(hitboxState *pList, int used, int tmpUsed) {
+    err erv;
+    int i;
+
+    ASSERT(used + tmpUsed <= MAX_HITBOXES, ERR_ARGUMENTBAD);
+
+    for (i = 0; i < used; i++) {
+        erv = _restoreHitboxAt(&pList[i], i);
+        ASSERT(erv == ERR_OK, erv);
+    }
+    for (i = MAX_HITBOXES - tmpUsed; i < MAX_HITBOXES; i++) {
+        erv = _restoreHitboxAt(&pList[i], i);
+        ASSERT(erv == ERR_OK, erv);
+    }
+    hitboxes.used = (uint8_t)used;
+    hitboxes.tmpUsed = (uint8_t)tmpUsed;
+
+    return ERR_OK;
+}
+
+/**
+ * Accumulate a hitbox into a hash. Its context is skipped, as it's a pointer.
+ *
+ * @param  [ in]hash   The current hash
+ * @param  [ in]pState The hitbox
+ * @return             The updated hash
+ */
+static uint32_t _hashHitbox(uint32_t hash, hitboxState *pState) {
+    hash = hashInt(hash, pState->x);
+    hash = hashInt(hash, pState->y);
+    hash = hashInt(hash, pState->width);
+    hash = hashInt(hash, pState->height);
+    hash = hashInt(hash, pState->type);
+    return hashInt(hash, pState->hitFlag);
+}
+
+/**
+ * Accumulate every live hitbox into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashHitboxes(uint32_t hash) {
+    int i;
+
+    hash = hashInt(hash, hitboxes.used);
+    hash = hashInt(hash, hitboxes.tmpUsed);
+    for (i = 0; i < hitboxes.used; i++) {
+        hash = _hashHitbox(hash, &hitboxes.states[i]);
+    }
+    for (i = MAX_HITBOXES - hitboxes.tmpUsed; i < MAX_HITBOXES; i++) {
+        hash = _hashHitbox(hash, &hitboxes.states[i]);
+    }
+
+    return hash;
+}
+
 /** Collide every hitbox */
 err collideHitbox() {
     err erv;
@@ -8,6 +8,8 @@
 #include <base/error.h>
 #include <base/game.h>
 #include <base/gfx.h>
+#include <base/sfx.h>
+#include <base/trace.h>
 
 #include <conf/game.h>
 #include <conf/type.h>
@@ -16,7 +18,10 @@
 #include <jjat2/gunny.h>
 #include <jjat2/leveltransition.h>
 #include <jjat2/playstate.h>
+#include <jjat2/snapshot.h>
 #include <jjat2/swordy.h>
+#include <jjat2/ui.h>
+#include <jjat2/world.h>
 
 #include <GFraMe/gfmCamera.h>
 #include <GFraMe/gfmHitbox.h>
@@ -174,10 +179,25 @@ void freeLeveltransition() {
 
 /** Prepare the transition animation */
 err setupLeveltransition() {
+    uint64_t start;
+    char *pSong;
+    err erv;
     gfmRV rv;
     int x, y;
 
+    start = traceBegin();
+
     ASSERT(lvltransition.pNextLevel != 0, ERR_INDEXOOB);
+    ASSERT(lvltransition.pNextLevel->level < LVL_COUNT, ERR_INDEXOOB);
+
+    /* Decode the next level's song while the transition plays, so it's ready
+     * by the time the level starts it. As in _parseResource, only the
+     * simulation bound to the window touches the audio */
+    pSong = pLevels[lvltransition.pNextLevel->level].pSong;
+    if (!(game.flags & CMD_HEADLESS) && pSong[0] != '\0') {
+        erv = prefetchSong(pSong);
+        ASSERT(erv == ERR_OK, erv);
+    }
 
     lvltransition.dir = lvltransition.pNextLevel->dir;
     lvltransition.srcX = lvltransition.pNextLevel->srcX;
@@ -220,6 +240,7 @@ err setupLeveltransition() {
     lvltransition.gunnyY = (uint16_t)y;
 
     lvltransition.timer = 0;
+    traceEnd(start, "setupLeveltransition");
 
     return ERR_OK;
 }
@@ -248,6 +269,22 @@ static void _getRelativePosition(int *x, int *y) {
     }
 }
 
+/**
+ * Check whether the next level may be restored from the snapshot taken when it
+ * was loaded, instead of reloading it from disk. Only done when respawning on
+ * the current level, and only if nothing that changes how the level gets
+ * loaded (i.e., the session flags) was modified since.
+ */
+static int _canRestoreLevel() {
+    snapshotCtx *pSnap = &snapshots.level;
+
+    return (lvltransition.flags & LT_CHECKPOINT)
+            && playstate.pNextLevel != 0
+            && isSnapshotValid(pSnap)
+            && playstate.pNextLevel->level == pSnap->level
+            && pSnap->sessionFlags == game.sessionFlags;
+}
+
 /** Update the transition animation */
 err updateLeveltransition() {
     err erv;
@@ -281,10 +318,21 @@ err updateLeveltransition() {
         gfmTilemap_setPosition(lvltransition.pTransition, cx - 16, cy - 16);
     }
     else if (!(lvltransition.flags & LT_LOADED)) {
-        erv = loadPlaystate();
-        ASSERT(erv == ERR_OK, erv);
-        rv = gfm_resetFPS(game.pCtx);
-        ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+        if (_canRestoreLevel()) {
+            erv = restoreSnapshot(&snapshots.level, SNAP_WORLD);
+            ASSERT(erv == ERR_OK, erv);
+            showUI();
+        }
+        else {
+            erv = loadPlaystate();
+            ASSERT(erv == ERR_OK, erv);
+        }
+        /* Headless simulations have no timer (their time comes from the
+         * replay) */
+        if (!(game.flags & CMD_HEADLESS)) {
+            rv = gfm_resetFPS(game.pCtx);
+            ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+        }
         lvltransition.flags |= LT_LOADED;
 
         /* After loading the stage, adjust the camera position and center the
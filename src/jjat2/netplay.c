@@ -0,0 +1,576 @@
+/**
+ * @file src/jjat2/netplay.c
+ *
+ * Rollback netplay between two peers, each controlling a single character.
+ *
+ * Every packet carries the input of the latest NETPLAY_REDUNDANCY frames and
+ * the sender's latest hash:
+ *   - the first frame (32 bits);
+ *   - the number of frames (8 bits);
+ *   - the frame of the hash (32 bits, NETPLAY_NO_HASH if none);
+ *   - the hash of the sender's playstate after that frame (32 bits);
+ *   - the buttons pressed on each frame (8 bits each).
+ * Every value is stored as little-endian.
+ *
+ * Once started, updating never allocates memory: every snapshot is allocated
+ * up front.
+ */
+#include <base/error.h>
+#include <base/game.h>
+#include <base/input.h>
+#include <base/loopback.h>
+#include <base/replay.h>
+
+#include <GFraMe/gfmInput.h>
+
+#include <jjat2/netplay.h>
+#include <jjat2/playstate.h>
+#include <jjat2/snapshot.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG(...) printf(__VA_ARGS__)
+
+/** Length of a packet's header */
+#define PACKET_HEADER_LEN   13
+/** Frame of the hash on packets sent before any frame was simulated */
+#define NETPLAY_NO_HASH     0xffffffff
+/** Length of a packet with every redundant input */
+#define PACKET_LEN          (PACKET_HEADER_LEN + NETPLAY_REDUNDANCY)
+
+/** Buttons sent for each frame, in the order of their bits */
+#define NETPLAY_BUTTONS     4
+
+/** Retrieve a button from its offset within the (thread-local) input */
+#define GET_BUTTON(offset) ((button*)((char*)&input + (offset)))
+
+/** Offset of each of the local player's buttons */
+static const size_t _pLocalButtons[NETPLAY_BUTTONS] = {
+    offsetof(inputCtx, swordyLeft)
+  , offsetof(inputCtx, swordyRight)
+  , offsetof(inputCtx, swordyJump)
+  , offsetof(inputCtx, swordyAtk)
+};
+
+/** Offset of each of the remote player's buttons */
+static const size_t _pRemoteButtons[NETPLAY_BUTTONS] = {
+    offsetof(inputCtx, gunnyLeft)
+  , offsetof(inputCtx, gunnyRight)
+  , offsetof(inputCtx, gunnyJump)
+  , offsetof(inputCtx, gunnyAtk)
+};
+
+/**
+ * Retrieve the buttons currently pressed, as a bitmask.
+ *
+ * @param  [ in]pList Offset of the buttons
+ */
+static uint8_t _readButtons(const size_t *pList) {
+    uint8_t bits;
+    int i;
+
+    bits = 0;
+    for (i = 0; i < NETPLAY_BUTTONS; i++) {
+        if (GET_BUTTON(pList[i])->state & gfmInput_pressed) {
+            bits |= 1 << i;
+        }
+    }
+
+    return bits;
+}
+
+/**
+ * Overwrite the buttons' states from a bitmask.
+ *
+ * @param  [ in]pList Offset of the buttons
+ * @param  [ in]bits  Buttons pressed on the frame
+ * @param  [ in]prev  Buttons pressed on the previous frame
+ */
+static void _applyButtons(const size_t *pList, uint8_t bits, uint8_t prev) {
+    int i;
+
+    for (i = 0; i < NETPLAY_BUTTONS; i++) {
+        button *pButton = GET_BUTTON(pList[i]);
+        int isPressed, wasPressed;
+
+        isPressed = bits & (1 << i);
+        wasPressed = prev & (1 << i);
+        if (isPressed && wasPressed) {
+            pButton->state = gfmInput_pressed;
+        }
+        else if (isPressed) {
+            pButton->state = gfmInput_justPressed;
+        }
+        else if (wasPressed) {
+            pButton->state = gfmInput_justReleased;
+        }
+        else {
+            pButton->state = gfmInput_released;
+        }
+    }
+}
+
+/**
+ * Store a little-endian 32 bits value.
+ *
+ * @param  [out]pDst The buffer
+ * @param  [ in]val  The value
+ */
+static void _writeU32(uint8_t *pDst, uint32_t val) {
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        pDst[i] = (val >> (i * 8)) & 0xff;
+    }
+}
+
+/**
+ * Read a little-endian 32 bits value.
+ *
+ * @param  [ in]pSrc The buffer
+ */
+static uint32_t _readU32(const uint8_t *pSrc) {
+    return pSrc[0] | (pSrc[1] << 8) | (pSrc[2] << 16)
+            | ((uint32_t)pSrc[3] << 24);
+}
+
+/**
+ * Send the input of the latest frames, along with the sender's latest hash.
+ *
+ * @param  [ in]channel   The channel
+ * @param  [ in]pHistory  Input on each frame
+ * @param  [ in]frame     The latest frame
+ * @param  [ in]hashFrame Frame of the hash (NETPLAY_NO_HASH if none)
+ * @param  [ in]hash      Hash of the sender's playstate after hashFrame
+ */
+static err _sendInput(int channel, uint8_t *pHistory, uint32_t frame
+        , uint32_t hashFrame, uint32_t hash) {
+    uint8_t pBuf[PACKET_LEN];
+    uint32_t first;
+    int i, count;
+
+    count = NETPLAY_REDUNDANCY;
+    if (frame + 1 < (uint32_t)count) {
+        count = (int)frame + 1;
+    }
+    first = frame + 1 - (uint32_t)count;
+
+    _writeU32(pBuf, first);
+    pBuf[4] = (uint8_t)count;
+    _writeU32(pBuf + 5, hashFrame);
+    _writeU32(pBuf + 9, hash);
+    for (i = 0; i < count; i++) {
+        pBuf[PACKET_HEADER_LEN + i] = pHistory[(first + i) % NETPLAY_HISTORY];
+    }
+
+    return loopbackSend(channel, pBuf, PACKET_HEADER_LEN + count);
+}
+
+/**
+ * Receive every remote input that arrived, detecting wrong predictions.
+ *
+ * @param  [io]pFrom Earliest frame that must be simulated again
+ */
+static void _receiveInput(uint32_t *pFrom) {
+    uint8_t pBuf[PACKET_LEN];
+    int len;
+
+    while ((len = loopbackReceive(NETPLAY_CHANNEL_IN, pBuf, sizeof(pBuf)))
+            > 0) {
+        uint32_t first, hashFrame;
+        int i, count;
+
+        if (len < PACKET_HEADER_LEN) {
+            continue;
+        }
+        first = _readU32(pBuf);
+        count = pBuf[4];
+        if (len < PACKET_HEADER_LEN + count) {
+            continue;
+        }
+
+        /* Only the latest hash has to be checked, since every hash depends on
+         * all of the previous frames */
+        hashFrame = _readU32(pBuf + 5);
+        if (hashFrame != NETPLAY_NO_HASH && hashFrame >= netplay.base
+                && (!netplay.hasCheck || hashFrame > netplay.checkFrame)) {
+            netplay.checkFrame = hashFrame;
+            netplay.checkHash = _readU32(pBuf + 9);
+            netplay.hasCheck = 1;
+        }
+
+        for (i = 0; i < count; i++) {
+            uint32_t f;
+            uint8_t bits;
+            int idx;
+
+            f = first + (uint32_t)i;
+            bits = pBuf[PACKET_HEADER_LEN + i];
+            idx = f % NETPLAY_HISTORY;
+            /* Skip inputs already received and those too far from the current
+             * frame (which would overwrite the history) */
+            if (netplay.pRemoteFrame[idx] == f
+                    || f + NETPLAY_HISTORY - NETPLAY_MAX_ROLLBACK
+                        <= netplay.frame
+                    || f >= netplay.frame + NETPLAY_MAX_ROLLBACK) {
+                continue;
+            }
+
+            netplay.pRemote[idx] = bits;
+            netplay.pRemoteFrame[idx] = f;
+            if (!netplay.didReceive || f > netplay.lastRemoteFrame) {
+                netplay.lastRemoteFrame = f;
+                netplay.lastRemote = bits;
+                netplay.didReceive = 1;
+            }
+
+            /* Roll back if the frame was already simulated with a wrong
+             * prediction */
+            if (f < netplay.frame && netplay.pUsed[idx] != bits) {
+                if (f < netplay.base
+                        || f + NETPLAY_MAX_ROLLBACK < netplay.frame) {
+                    netplay.lateInputs++;
+                }
+                else if (f < *pFrom) {
+                    *pFrom = f;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Retrieve the remote input for a frame, predicting it if it hasn't arrived.
+ *
+ * @param  [ in]frame The frame
+ */
+static uint8_t _getRemoteInput(uint32_t frame) {
+    int idx = frame % NETPLAY_HISTORY;
+
+    if (netplay.pRemoteFrame[idx] == frame) {
+        return netplay.pRemote[idx];
+    }
+    return netplay.lastRemote;
+}
+
+/**
+ * Simulate a single frame of the playstate from both players' input.
+ *
+ * @param  [ in]frame      The frame
+ * @param  [ in]local      Local input on the frame
+ * @param  [ in]localPrev  Local input on the previous frame
+ * @param  [ in]remote     Remote input on the frame
+ * @param  [ in]remotePrev Remote input on the previous frame
+ */
+static err _simulateInput(uint32_t frame, uint8_t local, uint8_t localPrev
+        , uint8_t remote, uint8_t remotePrev) {
+    _applyButtons(_pLocalButtons, local, localPrev);
+    _applyButtons(_pRemoteButtons, remote, remotePrev);
+    game.elapsed = netplay.pElapsed[frame % NETPLAY_HISTORY];
+
+    return simulatePlaystate();
+}
+
+/**
+ * Simulate a single frame from its stored input, taking a snapshot beforehand.
+ *
+ * @param  [ in]frame The frame
+ */
+static err _simulateFrame(uint32_t frame) {
+    uint8_t localPrev, remotePrev;
+    int idx, prevIdx;
+    err erv;
+
+    idx = frame % NETPLAY_HISTORY;
+    prevIdx = (frame + NETPLAY_HISTORY - 1) % NETPLAY_HISTORY;
+    localPrev = 0;
+    remotePrev = 0;
+    if (frame > 0) {
+        localPrev = netplay.pLocal[prevIdx];
+        remotePrev = netplay.pUsed[prevIdx];
+    }
+
+    takeSnapshot(&netplay.pSnapshots[frame % NETPLAY_MAX_ROLLBACK]);
+
+    netplay.pUsed[idx] = _getRemoteInput(frame);
+    erv = _simulateInput(frame, netplay.pLocal[idx], localPrev
+            , netplay.pUsed[idx], remotePrev);
+    ASSERT(erv == ERR_OK, erv);
+    netplay.pHash[idx] = getSimulationHash();
+
+    if (game.nextState != ST_NONE) {
+        /* Leaving the playstate can't be undone */
+        netplay.base = frame + 1;
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Receive every local input that arrived on the emulated remote peer.
+ */
+static void _receivePeerInput() {
+    uint8_t pBuf[PACKET_LEN];
+    int len;
+
+    while ((len = loopbackReceive(NETPLAY_CHANNEL_OUT, pBuf, sizeof(pBuf)))
+            > 0) {
+        uint32_t first;
+        int i, count;
+
+        if (len < PACKET_HEADER_LEN) {
+            continue;
+        }
+        first = _readU32(pBuf);
+        count = pBuf[4];
+        if (len < PACKET_HEADER_LEN + count) {
+            continue;
+        }
+
+        for (i = 0; i < count; i++) {
+            uint32_t f;
+            int idx;
+
+            f = first + (uint32_t)i;
+            idx = f % NETPLAY_HISTORY;
+            /* The peer is never behind by more than the history */
+            netplay.pPeerLocal[idx] = pBuf[PACKET_HEADER_LEN + i];
+            netplay.pPeerLocalFrame[idx] = f;
+        }
+    }
+}
+
+/**
+ * Simulate the emulated remote peer on every frame whose input it already
+ * received. Its playstate is swapped with the local one while doing so.
+ */
+static err _updatePeer() {
+    leveltransitionData *pNextLevel;
+    uint32_t stop;
+    state nextState;
+    err erv;
+
+    _receivePeerInput();
+
+    /* Only frames already simulated locally are simulated by the peer, so it
+     * never reaches a level transition (unless both peers diverged) */
+    stop = netplay.peerFrame;
+    while (stop < netplay.frame
+            && netplay.pPeerLocalFrame[stop % NETPLAY_HISTORY] == stop) {
+        stop++;
+    }
+    if (!netplay.peerActive || stop == netplay.peerFrame) {
+        return ERR_OK;
+    }
+
+    /* Keep whatever lives outside the snapshots */
+    nextState = game.nextState;
+    pNextLevel = playstate.pNextLevel;
+    takeSnapshot(netplay.pLocalState);
+    erv = restoreSnapshot(netplay.pPeerState, SNAP_ALL);
+    ASSERT(erv == ERR_OK, erv);
+
+    while (netplay.peerFrame < stop) {
+        uint8_t local, remote;
+        int idx;
+
+        idx = netplay.peerFrame % NETPLAY_HISTORY;
+        local = netplay.pPeerLocal[idx];
+        remote = netplay.pPeer[idx];
+        erv = _simulateInput(netplay.peerFrame, local, netplay.peerPrevLocal
+                , remote, netplay.peerPrevRemote);
+        ASSERT(erv == ERR_OK, erv);
+
+        netplay.peerPrevLocal = local;
+        netplay.peerPrevRemote = remote;
+        netplay.peerHash = getSimulationHash();
+        netplay.peerFrame++;
+
+        if (game.nextState != ST_NONE) {
+            /* The peer can't follow a level transition. Since the local
+             * playstate didn't leave on this frame, the hashes will differ */
+            netplay.peerActive = 0;
+            break;
+        }
+    }
+
+    takeSnapshot(netplay.pPeerState);
+    game.nextState = nextState;
+    playstate.pNextLevel = pNextLevel;
+    erv = restoreSnapshot(netplay.pLocalState, SNAP_ALL);
+    ASSERT(erv == ERR_OK, erv);
+
+    return ERR_OK;
+}
+
+/**
+ * Compare the latest remote hash against the local one, once its frame can't
+ * be rolled back anymore.
+ */
+static void _checkRemoteHash() {
+    uint32_t f;
+    int idx;
+
+    if (!netplay.hasCheck) {
+        return;
+    }
+
+    /* Wait until every remote input up to the frame arrived (or until the
+     * frame got too old to be rolled back) */
+    for (f = netplay.base; f <= netplay.checkFrame; f++) {
+        if (f + NETPLAY_MAX_ROLLBACK < netplay.frame) {
+            continue;
+        }
+        else if (f >= netplay.frame
+                || netplay.pRemoteFrame[f % NETPLAY_HISTORY] != f) {
+            return;
+        }
+    }
+    netplay.hasCheck = 0;
+
+    idx = netplay.checkFrame % NETPLAY_HISTORY;
+    if (netplay.checkFrame < netplay.base
+            || netplay.checkFrame + NETPLAY_HISTORY <= netplay.frame
+            || netplay.pHash[idx] == netplay.checkHash) {
+        return;
+    }
+
+    if (netplay.desyncs == 0) {
+        netplay.desyncFrame = netplay.checkFrame;
+        LOG("Netplay diverged on frame %u (remote %08x, local %08x)\n"
+                , (unsigned)netplay.checkFrame, (unsigned)netplay.checkHash
+                , (unsigned)netplay.pHash[idx]);
+    }
+    netplay.desyncs++;
+}
+
+/**
+ * Start a netplay session over the (previously configured) loopback transport.
+ * The local player controls swordy, and gunny is controlled by the emulated
+ * remote peer.
+ */
+err startNetplay() {
+    ASSERT(!netplay.active, ERR_ARGUMENTBAD);
+
+    netplay.pSnapshots = calloc(NETPLAY_MAX_ROLLBACK, sizeof(snapshotCtx));
+    ASSERT(netplay.pSnapshots, ERR_OOM);
+    netplay.pPeerState = calloc(1, sizeof(snapshotCtx));
+    ASSERT(netplay.pPeerState, ERR_OOM);
+    netplay.pLocalState = calloc(1, sizeof(snapshotCtx));
+    ASSERT(netplay.pLocalState, ERR_OOM);
+
+    /* Mark every remote input as not received */
+    memset(netplay.pRemoteFrame, 0xff, sizeof(netplay.pRemoteFrame));
+    memset(netplay.pPeerLocalFrame, 0xff, sizeof(netplay.pPeerLocalFrame));
+    netplay.frame = 0;
+    netplay.base = 0;
+    netplay.didReceive = 0;
+    netplay.lastRemote = 0;
+    netplay.active = 1;
+
+    return ERR_OK;
+}
+
+/** Stop the netplay session (if any) and release its memory */
+void stopNetplay() {
+    free(netplay.pSnapshots);
+    free(netplay.pPeerState);
+    free(netplay.pLocalState);
+    memset(&netplay, 0x0, sizeof(netplayCtx));
+}
+
+/** Forbid rolling back before the current frame (e.g., on a level load). The
+ * emulated peer restarts from the current playstate. */
+void resetNetplayRollback() {
+    uint32_t prevIdx;
+
+    if (!netplay.active) {
+        return;
+    }
+
+    netplay.base = netplay.frame;
+    netplay.hasCheck = 0;
+
+    /* Both peers start from the same state and from the same input on the
+     * previous frame */
+    takeSnapshot(netplay.pPeerState);
+    netplay.peerFrame = netplay.frame;
+    netplay.peerPrevLocal = 0;
+    netplay.peerPrevRemote = 0;
+    if (netplay.frame > 0) {
+        prevIdx = (netplay.frame - 1) % NETPLAY_HISTORY;
+        netplay.peerPrevLocal = netplay.pLocal[prevIdx];
+        netplay.peerPrevRemote = netplay.pUsed[prevIdx];
+    }
+    netplay.peerActive = 1;
+}
+
+/** Exchange the input for the current frame and simulate it (rolling back if
+ * any prediction was wrong) */
+err updateNetplay() {
+    uint32_t frame, from, hashFrame;
+    err erv;
+    int idx;
+
+    frame = netplay.frame;
+    idx = frame % NETPLAY_HISTORY;
+
+    /* Read both players before their buttons get overwritten by the
+     * simulation */
+    netplay.pLocal[idx] = _readButtons(_pLocalButtons);
+    netplay.pPeer[idx] = _readButtons(_pRemoteButtons);
+    netplay.pElapsed[idx] = (int16_t)game.elapsed;
+
+    /* The emulated peer doesn't check the local hash, but it's sent anyway,
+     * as a real peer would */
+    hashFrame = NETPLAY_NO_HASH;
+    if (frame > netplay.base) {
+        hashFrame = frame - 1;
+    }
+    erv = _sendInput(NETPLAY_CHANNEL_OUT, netplay.pLocal, frame, hashFrame
+            , netplay.pHash[(frame + NETPLAY_HISTORY - 1) % NETPLAY_HISTORY]);
+    ASSERT(erv == ERR_OK, erv);
+
+    /* Emulate the remote peer: send gunny's input and the hash of its latest
+     * frame */
+    hashFrame = NETPLAY_NO_HASH;
+    if (netplay.peerActive && netplay.peerFrame > netplay.base) {
+        hashFrame = netplay.peerFrame - 1;
+    }
+    erv = _sendInput(NETPLAY_CHANNEL_IN, netplay.pPeer, frame, hashFrame
+            , netplay.peerHash);
+    ASSERT(erv == ERR_OK, erv);
+
+    updateLoopback(game.elapsed);
+
+    from = frame;
+    _receiveInput(&from);
+
+    netplay.resimulated = 0;
+    if (from < frame) {
+        erv = restoreSnapshot(&netplay.pSnapshots[from % NETPLAY_MAX_ROLLBACK]
+                , SNAP_ALL);
+        ASSERT(erv == ERR_OK, erv);
+
+        while (from < frame) {
+            erv = _simulateFrame(from);
+            ASSERT(erv == ERR_OK, erv);
+            netplay.resimulated++;
+            from++;
+        }
+    }
+    _checkRemoteHash();
+
+    erv = _updatePeer();
+    ASSERT(erv == ERR_OK, erv);
+
+    erv = _simulateFrame(frame);
+    ASSERT(erv == ERR_OK, erv);
+    netplay.frame++;
+
+    return ERR_OK;
+}
@@ -3,10 +3,13 @@
  */
 #include <base/collision.h>
 #include <base/error.h>
+#include <base/framepacer.h>
 #include <base/game.h>
 #include <base/gfx.h>
+#include <base/hash.h>
 #include <base/input.h>
 #include <base/sfx.h>
+#include <base/trace.h>
 
 #include <conf/game.h>
 
@@ -23,15 +26,22 @@
 #include <jjat2/enemy.h>
 #include <jjat2/entity.h>
 #include <jjat2/event.h>
+#include <jjat2/events/signal.h>
+#include <jjat2/floorspan.h>
 #include <jjat2/fx_group.h>
 #include <jjat2/gunny.h>
 #include <jjat2/hitbox.h>
 #include <jjat2/leveltransition.h>
+#include <jjat2/netplay.h>
 #include <jjat2/playstate.h>
+#include <jjat2/rewind.h>
+#include <jjat2/snapshot.h>
 #include <jjat2/swordy.h>
 #include <jjat2/teleport.h>
+#include <jjat2/tilequery.h>
 #include <jjat2/ui.h>
 
+#include <stdlib.h>
 #include <string.h>
 
 #if defined(JJAT_ENABLE_BACKGROUND)
@@ -45,8 +55,8 @@ static int pBgAnimData[] = {
 static int bgAnimDataLen = sizeof(pBgAnimData) / sizeof(int);
 #endif /* JJAT_ENABLE_BACKGROUND */
 
-/** Region where the names of maps accessible from the current one are stored */
-static char _stMapsName[MAX_AREAS * (MAX_VALID_LEN + 1)];
+/** Hash of everything visible on the last update, used to skip idle frames */
+static SIM_LOCAL uint32_t _sceneHash;
 
 enum enLevelInfoFlags {
     LIF_NAME = 0x01
@@ -133,10 +143,16 @@ void freePlaystate() {
     if (playstate.pBackground != 0) {
         gfmTilemap_free(&playstate.pBackground);
     }
+    free(playstate.pBgAnimated);
+    playstate.pBgAnimated = 0;
+    playstate.bgAnimatedLen = 0;
 #endif /* JJAT_ENABLE_BACKGROUND */
     if (playstate.pParser != 0) {
         gfmParser_free(&playstate.pParser);
     }
+    freeFloorSpans();
+    freeTileTypes();
+    freeTileView(&playstate.mapView);
     freeSwordy(&playstate.swordy);
     freeGunny(&playstate.gunny);
 
@@ -147,15 +163,6 @@ void freePlaystate() {
     }
 }
 
-/**
- * Setup pointers within a hitboxCtx's level transition data.
- *
- * @param  [ in]i Context's index
- */
-static void _setupLevelTransitionData(int i) {
-    playstate.data[i].ltData.pName = _stMapsName + (MAX_VALID_LEN + 1) * i;
-}
-
 /**
  * Setup loading the next map.
  *
@@ -321,7 +328,7 @@ static err _parseLevelInfo(gfmParser *pParser, leveltransitionData *pInfo
     pInfo->dir = -1;
     pInfo->tgtX = 0xffff;
     pInfo->tgtY = 0xffff;
-    pInfo->pName[0] = '\0';
+    pInfo->level = LVL_NONE;
 
     i = 0;
     while (i < l) {
@@ -345,8 +352,10 @@ static err _parseLevelInfo(gfmParser *pParser, leveltransitionData *pInfo
             pInfo->tgtY = (uint16_t)val * 8;
         }
         else if (strcmp(pKey, "dest") == 0) {
-            ASSERT(strlen(pVal) < MAX_VALID_LEN, ERR_PARSINGERR);
-            strcpy(pInfo->pName, pVal);
+            err erv;
+
+            erv = getLevelId(&pInfo->level, pVal);
+            ASSERT(erv == ERR_OK, erv);
         }
         else if (strcmp(pKey, "dir") == 0) {
             if (strcmp(pVal, "left") == 0) {
@@ -372,7 +381,7 @@ static err _parseLevelInfo(gfmParser *pParser, leveltransitionData *pInfo
     ASSERT(!(required & LIF_DIR) || pInfo->dir != -1, ERR_PARSINGERR);
     ASSERT(!(required & LIF_TGTX) || pInfo->tgtX != 0xffff, ERR_PARSINGERR);
     ASSERT(!(required & LIF_TGTY) || pInfo->tgtY != 0xffff, ERR_PARSINGERR);
-    ASSERT(!(required & LIF_NAME) || pInfo->pName[0] != '\0', ERR_PARSINGERR);
+    ASSERT(!(required & LIF_NAME) || pInfo->level != LVL_NONE, ERR_PARSINGERR);
             
 
     return ERR_OK;
@@ -396,7 +405,6 @@ static err _parseLoadzone(gfmParser *pParser) {
     rv = gfmParser_getDimensions(&w, &h, pParser);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
-    _setupLevelTransitionData(playstate.areasCount);
     pData = &(playstate.data[playstate.areasCount].ltData);
     erv = _parseLevelInfo(pParser, pData
             , (LIF_NAME | LIF_TGTX | LIF_TGTY | LIF_DIR));
@@ -477,9 +485,8 @@ static err _parseInvisibleWall(gfmParser *pParser) {
  * Parse a checkpoint
  *
  * @param  [ in]pParser    The parser pointing at a checkpoint
- * @param  [ in]pLevelName Name of the current level
  */
-static err _parseCheckpoint(gfmParser *pParser, const char *pLevelName) {
+static err _parseCheckpoint(gfmParser *pParser) {
     leveltransitionData *pData;
     gfmRV rv;
     int h, w, x, y;
@@ -491,11 +498,8 @@ static err _parseCheckpoint(gfmParser *pParser, const char *pLevelName) {
     rv = gfmParser_getDimensions(&w, &h, pParser);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
-    _setupLevelTransitionData(playstate.areasCount);
     pData = &(playstate.data[playstate.areasCount].ltData);
-    /* pLevelName should be the name of the loaded file. Therefore, it must have
-     * a valid length and terminator (unless it got corrupted...) */
-    strcpy(pData->pName, pLevelName);
+    pData->level = playstate.level;
     /* Set the target position based on the checkpoint's position */
     pData->tgtX = (uint16_t)(x + w / 2);
     pData->tgtY = (uint16_t)(y + h - TILES_TO_PX(2));
@@ -524,6 +528,11 @@ static err _parseResource(gfmParser *pParser) {
         ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
         if (strcmp(pKey, "play") == 0) {
+            /* The audio is shared by every simulation, so only the one bound
+             * to the window may play songs */
+            if (game.flags & CMD_HEADLESS) {
+                return ERR_OK;
+            }
             return playSong(pVal);
         }
 #if 0
@@ -542,100 +551,126 @@ static err _parseResource(gfmParser *pParser) {
     return ERR_OK;
 }
 
+#if defined(JJAT_ENABLE_BACKGROUND)
+/**
+ * Flag which of the background's tiles are animated, so idle frames may be
+ * detected without going through the animations. The table covers every tile
+ * on the loaded background and every frame of its animations (which are the
+ * only tiles the background may change into).
+ */
+static err _buildBgAnimTable() {
+    uint8_t *pTable;
+    int *pData;
+    int i, height, len, max, width;
+
+    gfmTilemap_getData(&pData, playstate.pBackground);
+    gfmTilemap_getDimension(&width, &height, playstate.pBackground);
+    len = (width / TILE_DIMENSION) * (height / TILE_DIMENSION);
+
+    max = -1;
+    for (i = 0; i < len; i++) {
+        if (pData[i] > max) {
+            max = pData[i];
+        }
+    }
+    i = 0;
+    while (i < bgAnimDataLen) {
+        int j;
+
+        /* Skip the len, fps and loop fields */
+        for (j = i + 3; j < i + 3 + pBgAnimData[i]; j++) {
+            if (pBgAnimData[j] > max) {
+                max = pBgAnimData[j];
+            }
+        }
+        i += 3 + pBgAnimData[i];
+    }
+
+    if (max + 1 > playstate.bgAnimatedLen) {
+        pTable = realloc(playstate.pBgAnimated, sizeof(uint8_t) * (max + 1));
+        ASSERT(pTable, ERR_OOM);
+        playstate.pBgAnimated = pTable;
+        playstate.bgAnimatedLen = max + 1;
+    }
+    memset(playstate.pBgAnimated, 0x0, sizeof(uint8_t) * (max + 1));
+
+    i = 0;
+    while (i < bgAnimDataLen) {
+        int j;
+
+        for (j = i + 3; j < i + 3 + pBgAnimData[i]; j++) {
+            playstate.pBgAnimated[pBgAnimData[j]] = 1;
+        }
+        i += 3 + pBgAnimData[i];
+    }
+
+    return ERR_OK;
+}
+#endif /* JJAT_ENABLE_BACKGROUND */
+
 /**
  * Load a level into the playstate
  *
- * Levels are expected to be on 'assets/levels/', and every level should have a
- * tilemap layer and an object layer, which should be named *_tm.gfm and
- * *_obj.gfm respectively.
+ * Every level has a tilemap layer and an object layer, whose paths are listed
+ * on the world's manifest (see jjat2/world.h).
  *
- * @param  [ in]levelName The name of the level, which will get the directory
- *                        prepended and then the layers and extension. Therefore
- *                        to load the level with layers on
- *                        "levels/map_test_tm.gfm" and "levels/map_test_obj.gfm"
- *                        one should call this function with "map_test" as its
- *                        argument. Note that this parameter may come from a
- *                        previous loaded loadzone. Therefore, as soon as
- *                        objects start to get parsed, this may be overwritten
+ * @param  [ in]level     The level. Note that this parameter may come from a
+ *                        previous loaded loadzone, so it's copied before
+ *                        objects start to get parsed
  * @param  [ in]setPlayer Whether the player position should be set from the map
  */
-static err _loadLevel(char *levelName, int setPlayer) {
-    char *pValidName;
-    char stLevelName[MAX_LEVEL_NAME];
-    int nameLen, pos;
+static err _loadLevel(levelId level, int setPlayer) {
+    const levelManifest *pLevel;
+    uint64_t start, step;
     gfmRV rv;
     err erv;
 
-/** Length of a static string */
-#define LEN(str) (sizeof(str) - 1)
-/** Append a static string to the level name */
-#define APPEND(str) \
-    do { \
-        memcpy(stLevelName + pos, str, sizeof(str)); \
-    } while (0)
-/** Append a static string to the level name and updates its position */
-#define APPEND_POS(str) \
-    do { \
-        APPEND(str); \
-        pos += LEN(str); \
-    } while (0)
-/** Append a dynamic string to the level name and updates its position */
-#define APPEND_DYN(str, len) \
-    do { \
-        memcpy(stLevelName + pos, str, len); \
-        pos += len; \
-    } while (0)
-
-    ASSERT(levelName != 0, ERR_ARGUMENTBAD);
-
-    /* Level names will get "levels/", "_tm.gfm" and "_obj.gfm" concatenated, so
-     * it must be at most this many characters long:
-     *     MAX_LEVEL_NAME - (sizeof("levels/") - 1) - (sizeof("_obj.gfm") - 1) - 1
-     * The last "- 1" is for the '\0'
-     */
-    nameLen = strlen(levelName);
-    ASSERT(nameLen <= MAX_LEVEL_NAME, ERR_INVALIDLEVELNAME);
-
-    pos = 0;
-    APPEND_POS("levels/");
-    /* Store this position as the one with a valid (i.e., immutable name) */
-    pValidName = stLevelName + pos;
-    /* TODO Check if levelName is actually a valid path */
-    APPEND_DYN(levelName, nameLen);
+    ASSERT(level > LVL_NONE && level < LVL_COUNT, ERR_INVALIDLEVELNAME);
+    pLevel = &pLevels[level];
+    start = traceBegin();
+    step = start;
 
     /* Load the tilemap */
-    APPEND("_fg_tm.gfm");
-    rv = gfmTilemap_newLoadf(playstate.pMap, game.pCtx, stLevelName
-            , pos + LEN("_fg_tm.gfm"), pDictNames, pDictTypes, dictLen
-            , pSidedTypes, sidedLen);
+    rv = gfmTilemap_newLoadf(playstate.pMap, game.pCtx, pLevel->pFgPath
+            , pLevel->fgLen, pDictNames, pDictTypes, dictLen, pSidedTypes
+            , sidedLen);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
     erv = _updateWorldSize();
     ASSERT(erv == ERR_OK, erv);
 
     erv = _updateActivableTiles();
     ASSERT(erv == ERR_OK, erv);
+    erv = syncTileView(&playstate.mapView, playstate.pMap);
+    ASSERT(erv == ERR_OK, erv);
+    erv = buildTileTypes();
+    ASSERT(erv == ERR_OK, erv);
+    erv = buildFloorSpans();
+    ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "loadTilemap");
 
 #if defined(JJAT_ENABLE_BACKGROUND)
     if (game.flags & FX_PRETTYRENDER) {
-        APPEND("_bg_tm.gfm");
-        rv = gfmTilemap_loadf(playstate.pBackground, game.pCtx, stLevelName
-                , pos + LEN("_bg_tm.gfm"), pDictNames, pDictTypes, dictLen);
+        rv = gfmTilemap_loadf(playstate.pBackground, game.pCtx
+                , pLevel->pBgPath, pLevel->bgLen, pDictNames, pDictTypes
+                , dictLen);
         ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+        erv = _buildBgAnimTable();
+        ASSERT(erv == ERR_OK, erv);
+        traceStep(&step, "loadBackground");
     }
 #endif /* JJAT_ENABLE_BACKGROUND */
 
     /* Load the objects */
-    APPEND("_obj.gfm");
-    rv = gfmParser_init(playstate.pParser, game.pCtx, stLevelName
-            , pos + LEN("_obj.gfm"));
-    ASSERT(erv == ERR_OK, erv);
+    rv = gfmParser_init(playstate.pParser, game.pCtx, pLevel->pObjPath
+            , pLevel->objLen);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
 
-    /* Since no other file is opened after this, clamp the level name */
-    pValidName[nameLen] = '\0';
+    playstate.level = level;
 
     playstate.entityCount = 0;
     playstate.areasCount = 0;
     resetHitboxes();
+    resetSignals();
     while (1) {
         char *type;
         err erv;
@@ -659,7 +694,7 @@ static err _loadLevel(char *levelName, int setPlayer) {
             ASSERT(erv == ERR_OK, erv);
         }
         else if (strcmp(type, "checkpoint") == 0) {
-            erv = _parseCheckpoint(playstate.pParser, pValidName);
+            erv = _parseCheckpoint(playstate.pParser);
             ASSERT(erv == ERR_OK, erv);
         }
         else if (strcmp(type, "swordy_pos") == 0) {
@@ -724,18 +759,20 @@ static err _loadLevel(char *levelName, int setPlayer) {
 
     rv = gfmParser_reset(playstate.pParser);
     ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    traceStep(&step, "parseObjects");
 
     erv = _loadStaticQuadtree();
     ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "loadStaticQuadtree");
 
     erv = resetCameraPosition(&playstate.swordy, &playstate.gunny);
     ASSERT(erv == ERR_OK, erv);
 
-    rv = gfmGroup_killAll(fx);
-    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    erv = killAllFx();
+    ASSERT(erv == ERR_OK, erv);
     resetTeleporterTarget();
 
-    setMapTitle(pValidName);
+    setMapTitle(pLevel->pName);
     showUI();
 
     if (setPlayer) {
@@ -758,34 +795,41 @@ static err _loadLevel(char *levelName, int setPlayer) {
         /* Setting the player position implies that this is the first level on
          * this playthrough (either a new game or a loaded one). Therefore,
          * setup the checkpoint */
-        data.pName = pValidName;
+        data.level = level;
         data.tgtX = (uint16_t)tgtX;
         data.tgtY = (uint16_t)tgtY;
         erv = setCheckpoint(&data);
         ASSERT(erv == ERR_OK, erv);
     }
 
-#undef LEN
-#undef APPEND_DYN
-#undef APPEND_POS
-#undef APPEND
-
     /* Set flags used to fix falling back though the level transition */
     playstate.flags = PF_FIRST_FRAME;
     playstate.lastTouch = 0;
+    traceStep(&step, "resetLevel");
+
+    /* Store the level as just loaded, so respawning on it doesn't have to
+     * reload it from disk */
+    takeSnapshot(&snapshots.level);
+    resetRewind();
+    resetNetplayRollback();
+    traceStep(&step, "takeSnapshot");
+    traceEnd(start, "loadLevel");
 
     return ERR_OK;
 }
 
 /** Setup the playstate so it may start to be executed */
 err loadPlaystate() {
-    if (playstate.pNextLevel == 0) {
+    if (playstate.pNextLevel == 0 && playstate.firstLevel != LVL_NONE) {
+        return _loadLevel(playstate.firstLevel, 1/*setPlayer*/);
+    }
+    else if (playstate.pNextLevel == 0) {
         /* Load the default first level */
         return _loadLevel(FIRST_MAP, 1/*setPlayer*/);
     }
     else {
         /* Load the level pointed by the loadzone */
-        return _loadLevel(playstate.pNextLevel->pName, 0/*setPlayer*/);
+        return _loadLevel(playstate.pNextLevel->level, 0/*setPlayer*/);
     }
 }
 
@@ -817,18 +861,186 @@ inline static void _handleAsyncCollision(entityCtx *pActive
     spawnTmpHitbox(0/*pCtx*/, x, y, w, h, type);
 }
 
-/** Update the playstate */
-err updatePlaystate() {
+
+/**
+ * Retrieve the tiles within the camera (plus a tile of margin on every side,
+ * for partially visible tiles).
+ *
+ * @param  [out]pX0    The first visible tile (inclusive)
+ * @param  [out]pY0    The first visible tile (inclusive)
+ * @param  [out]pX1    The last visible tile (exclusive)
+ * @param  [out]pY1    The last visible tile (exclusive)
+ * @param  [ in]width  The tilemap's dimensions, in tiles
+ * @param  [ in]height The tilemap's dimensions, in tiles
+ */
+static void _getVisibleTiles(int *pX0, int *pY0, int *pX1, int *pY1, int width
+        , int height) {
+    int cx, cy;
+
+    gfmCamera_getPosition(&cx, &cy, game.pCamera);
+
+    *pX0 = cx / TILE_DIMENSION - 1;
+    if (*pX0 < 0) {
+        *pX0 = 0;
+    }
+    *pY0 = cy / TILE_DIMENSION - 1;
+    if (*pY0 < 0) {
+        *pY0 = 0;
+    }
+    *pX1 = (cx + V_WIDTH) / TILE_DIMENSION + 2;
+    if (*pX1 > width) {
+        *pX1 = width;
+    }
+    *pY1 = (cy + V_HEIGHT) / TILE_DIMENSION + 2;
+    if (*pY1 > height) {
+        *pY1 = height;
+    }
+}
+
+#if defined(JJAT_ENABLE_BACKGROUND)
+/**
+ * Accumulate the tiles of a tilemap within the camera into a hash
+ *
+ * @param  [out]pAnimated Set if any animated tile is visible
+ * @param  [ in]hash      The current hash
+ * @param  [ in]pTilemap  The tilemap
+ * @return                The updated hash
+ */
+static uint32_t _hashVisibleTiles(int *pAnimated, uint32_t hash
+        , gfmTilemap *pTilemap) {
+    int *pData;
+    int height, width, x, x0, x1, y, y0, y1;
+
+    gfmTilemap_getData(&pData, pTilemap);
+    gfmTilemap_getDimension(&width, &height, pTilemap);
+    width /= TILE_DIMENSION;
+    height /= TILE_DIMENSION;
+
+    _getVisibleTiles(&x0, &y0, &x1, &y1, width, height);
+    for (y = y0; y < y1; y++) {
+        int *pRow;
+
+        pRow = pData + y * width;
+        for (x = x0; x < x1; x++) {
+            /* Tiles are either empty or covered by the table (see
+             * _buildBgAnimTable) */
+            if (pRow[x] >= 0 && playstate.pBgAnimated[pRow[x]]) {
+                *pAnimated = 1;
+            }
+            hash = hashInt(hash, pRow[x]);
+        }
+    }
+
+    return hash;
+}
+#endif /* JJAT_ENABLE_BACKGROUND */
+
+/**
+ * Accumulate the tiles of a view within the camera into a hash
+ *
+ * @param  [ in]hash  The current hash
+ * @param  [ in]pView The view
+ * @return            The updated hash
+ */
+static uint32_t _hashVisibleView(uint32_t hash, tileView *pView) {
+    int x0, x1, y, y0, y1;
+
+    _getVisibleTiles(&x0, &y0, &x1, &y1, pView->width, pView->height);
+    if (x0 >= x1) {
+        return hash;
+    }
+
+    /* Rows are contiguous, so each one is hashed at once */
+    for (y = y0; y < y1; y++) {
+        hash = hashBuf(hash, pView->pTiles + x0 + y * pView->width
+                , sizeof(uint16_t) * (x1 - x0));
+    }
+
+    return hash;
+}
+
+/**
+ * Accumulate everything that affects how a sprite is rendered into a hash
+ *
+ * @param  [ in]hash The current hash
+ * @param  [ in]pSpr The sprite
+ * @return           The updated hash
+ */
+static uint32_t _hashSprite(uint32_t hash, gfmSprite *pSpr) {
+    int flip, frame, x, y;
+
+    gfmSprite_getPosition(&x, &y, pSpr);
+    gfmSprite_getFrame(&frame, pSpr);
+    gfmSprite_getDirection(&flip, pSpr);
+
+    hash = hashInt(hash, x);
+    hash = hashInt(hash, y);
+    hash = hashInt(hash, frame);
+    return hashInt(hash, flip);
+}
+
+/**
+ * Check whether anything visible changed since the last time this was called.
+ *
+ * Since the background's animations aren't exposed, it's considered as changing
+ * whenever an animated tile is on screen. Effects are handled similarly.
+ *
+ * @return 1 if anything changed, 0 otherwise
+ */
+static int _didSceneChange() {
+    uint32_t hash;
+    int animated, cx, cy, i;
+
+    animated = !isFxGroupIdle();
+
+    hash = HASH_INIT;
+    hash = hashInt(hash, game.flags);
+    hash = hashInt(hash, game.sessionFlags);
+    gfmCamera_getPosition(&cx, &cy, game.pCamera);
+    hash = hashInt(hash, cx);
+    hash = hashInt(hash, cy);
+
+    hash = _hashSprite(hash, playstate.swordy.pSelf);
+    hash = _hashSprite(hash, playstate.gunny.pSelf);
+    i = 0;
+    while (i < playstate.entityCount) {
+        hash = hashInt(hash, playstate.entities[i].flags & EF_ALIVE);
+        hash = _hashSprite(hash, playstate.entities[i].pSelf);
+        i++;
+    }
+
+    hash = _hashVisibleView(hash, &playstate.mapView);
+#if defined(JJAT_ENABLE_BACKGROUND)
+    if (game.flags & FX_PRETTYRENDER) {
+        hash = _hashVisibleTiles(&animated, hash, playstate.pBackground);
+    }
+#endif /* JJAT_ENABLE_BACKGROUND */
+    hash = hashUI(hash);
+
+    if (hash != _sceneHash) {
+        _sceneHash = hash;
+        return 1;
+    }
+    return animated;
+}
+
+/**
+ * Simulate a single frame of the playstate, from the current input and elapsed
+ * time
+ */
+err simulatePlaystate() {
+    uint64_t start, step;
     gfmRV rv;
     err erv;
     int i;
 
-    /* Local variables are cleared on the start of every frame, since they shall
-     * be later set on event's pre-update */
-    clearLocalVariables();
+    start = traceBegin();
+    step = start;
 
     playstate.flags &= ~(PF_TEL_SWORDY | PF_TEL_GUNNY);
+    playstate.killed = 0;
     resetTmpHitboxes();
+    clearCarryGraph();
 
     if ((playstate.flags & PF_FIRST_FRAME) &&
             playstate.lastTouch > 0 &&
@@ -876,6 +1088,7 @@ err updatePlaystate() {
     ASSERT(erv == ERR_OK, erv);
     erv = preUpdateGunny(&playstate.gunny);
     ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "preUpdate");
 
     /* Fix the collision between both players, if only one is active */
     if ((game.flags & AC_BOTH) == AC_BOTH) {
@@ -892,9 +1105,19 @@ err updatePlaystate() {
      * everyting was spawned this frame) */
     erv = updateFxGroup();
     ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "updateFx");
 
+    /* Besides colliding, this lists every carried entity on the carry graph,
+     * which is only resolved (and traced) afterwards */
     erv = collideHitbox();
     ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "collideHitboxes");
+
+    /* Every entity was already collided, so carried ones may be moved along
+     * their carriers */
+    erv = resolveCarryGraph();
+    ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "carry");
 
     i = 0;
     while (i < playstate.entityCount) {
@@ -910,6 +1133,7 @@ err updatePlaystate() {
     ASSERT(erv == ERR_OK, erv);
     erv = postUpdateGunny(&playstate.gunny);
     ASSERT(erv == ERR_OK, erv);
+    traceStep(&step, "postUpdate");
 
     /** Check if a loadzone was triggered by both players */
     if ((playstate.flags & (PF_TEL_SWORDY | PF_TEL_GUNNY)) != 0 &&
@@ -949,6 +1173,13 @@ err updatePlaystate() {
             || !(playstate.gunny.flags & EF_ALIVE)
             || ((game.sessionFlags & SF_ENABLE_RESET)
                 && DID_JUST_PRESS(reset))) {
+        if (!(playstate.swordy.flags & EF_ALIVE)) {
+            playstate.killed |= AC_SWORDY;
+        }
+        if (!(playstate.gunny.flags & EF_ALIVE)) {
+            playstate.killed |= AC_GUNNY;
+        }
+
         erv = loadCheckpoint();
         ASSERT(erv == ERR_OK, erv);
 
@@ -956,15 +1187,72 @@ err updatePlaystate() {
         playstate.gunny.flags |= EF_ALIVE;
     }
 
+    /* Headless simulations are never drawn (and the frame pacer is shared) */
+    if (!(game.flags & CMD_HEADLESS) && _didSceneChange()) {
+        markFrameDirty();
+    }
+    traceStep(&step, "lateUpdate");
+    traceEnd(start, "simulatePlaystate");
+
+    return ERR_OK;
+}
+
+/** Update the playstate */
+err updatePlaystate() {
+    uint64_t start;
+    err erv;
+
+    start = traceBegin();
+
+#if defined(DEBUG)
+    if (DID_JUST_RELEASE(dbgSaveState)) {
+        takeSnapshot(&snapshots.debug);
+    }
+    else if (DID_JUST_RELEASE(dbgLoadState)
+            && isSnapshotValid(&snapshots.debug)) {
+        erv = restoreSnapshot(&snapshots.debug, SNAP_ALL);
+        ASSERT(erv == ERR_OK, erv);
+        resetRewind();
+        resetNetplayRollback();
+    }
+
+    if (IS_PRESSED(dbgRewind)) {
+        /* Scrub back a frame, instead of simulating a new one */
+        erv = rewindStep();
+        ASSERT(erv == ERR_OK, erv);
+        resetNetplayRollback();
+        markFrameDirty();
+        traceEnd(start, "rewind");
+        return ERR_OK;
+    }
+#endif /* DEBUG */
+
+    if (netplay.active) {
+        erv = updateNetplay();
+    }
+    else {
+        erv = simulatePlaystate();
+    }
+    ASSERT(erv == ERR_OK, erv);
+
+#if defined(DEBUG)
+    erv = captureRewindFrame();
+    ASSERT(erv == ERR_OK, erv);
+#endif /* DEBUG */
+    traceEnd(start, "updatePlaystate");
+
     return ERR_OK;
 }
 
 /** Draw the playstate */
 err drawPlaystate() {
+    uint64_t start;
     gfmRV rv;
     err erv;
     int i, nodes, buckets;
 
+    start = traceBegin();
+
 #if defined(JJAT_ENABLE_BACKGROUND)
     if (game.flags & FX_PRETTYRENDER) {
         int height, width, x, y;
@@ -1061,6 +1349,7 @@ err drawPlaystate() {
     gfmDebug_printf(game.pCtx, 0, 128, "DYNAMIC\nNODES  : %i\nBUCKETS: %i", nodes, buckets);
     gfmQuadtree_getNumNodes(&nodes, &buckets, collision.pStaticQt);
     gfmDebug_printf(game.pCtx, 0, 128+8*4, "STATIC\nNODES  : %i\nBUCKETS: %i", nodes, buckets);
+    traceEnd(start, "drawPlaystate");
 
     return ERR_OK;
 }
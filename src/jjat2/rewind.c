@@ -0,0 +1,295 @@
+/**
+ * @file src/jjat2/rewind.c
+ *
+ * Keep the last few seconds of the simulation, so it may be scrubbed backward.
+ *
+ * A frame is encoded as a sequence of runs, each with:
+ *   - the number of unchanged bytes (16 bits);
+ *   - the number of changed bytes (16 bits);
+ *   - the changed bytes, XOR'ed against the keyframe.
+ * Keyframes are encoded just the same, but against an all-zeros snapshot.
+ */
+#include <base/error.h>
+
+#include <jjat2/rewind.h>
+#include <jjat2/snapshot.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Maximum length of a single run */
+#define RUN_MAX             0xffff
+/** Length of a run's header */
+#define RUN_HEADER_LEN      4
+/** Worst case length of an encoded snapshot. Changed bytes only stop a run
+ * on two consecutive unchanged bytes, so every run encodes at least 3 bytes
+ * into at most 5 bytes */
+#define MAX_ENCODED_LEN     (sizeof(snapshotCtx) * 2 + RUN_HEADER_LEN)
+
+/**
+ * Retrieve a byte of the difference between two buffers.
+ *
+ * @param  [ in]pCur  The new buffer
+ * @param  [ in]pBase The previous buffer (NULL if all zeros)
+ * @param  [ in]i     The byte's index
+ */
+static inline uint8_t _diff(const uint8_t *pCur, const uint8_t *pBase, int i) {
+    if (pBase == 0) {
+        return pCur[i];
+    }
+    return pCur[i] ^ pBase[i];
+}
+
+/**
+ * Encode the difference between two snapshots.
+ *
+ * @param  [out]pDst  The encoded difference (at least MAX_ENCODED_LEN bytes)
+ * @param  [ in]pCur  The new snapshot
+ * @param  [ in]pBase The previous snapshot (NULL if all zeros)
+ * @return            Length of the encoded difference
+ */
+static uint32_t _encode(uint8_t *pDst, const snapshotCtx *pCur
+        , const snapshotCtx *pBase) {
+    const uint8_t *pC, *pB;
+    uint32_t pos;
+    int i, len;
+
+    pC = (const uint8_t*)pCur;
+    pB = (const uint8_t*)pBase;
+    len = (int)sizeof(snapshotCtx);
+
+    i = 0;
+    pos = 0;
+    while (i < len) {
+        int j, skip, changed;
+
+        skip = 0;
+        while (i < len && skip < RUN_MAX && _diff(pC, pB, i) == 0) {
+            skip++;
+            i++;
+        }
+
+        changed = 0;
+        while (i + changed < len && changed < RUN_MAX
+                && (_diff(pC, pB, i + changed) != 0
+                    || (i + changed + 1 < len
+                        && _diff(pC, pB, i + changed + 1) != 0))) {
+            changed++;
+        }
+
+        pDst[pos++] = skip & 0xff;
+        pDst[pos++] = (skip >> 8) & 0xff;
+        pDst[pos++] = changed & 0xff;
+        pDst[pos++] = (changed >> 8) & 0xff;
+        for (j = 0; j < changed; j++) {
+            pDst[pos++] = _diff(pC, pB, i + j);
+        }
+        i += changed;
+    }
+
+    return pos;
+}
+
+/**
+ * Apply an encoded difference over a snapshot.
+ *
+ * @param  [ in]pSnap The snapshot
+ * @param  [ in]pSrc  The encoded difference
+ * @param  [ in]len   Length of the encoded difference
+ */
+static void _decode(snapshotCtx *pSnap, const uint8_t *pSrc, uint32_t len) {
+    uint8_t *pDst;
+    uint32_t pos;
+    int i;
+
+    pDst = (uint8_t*)pSnap;
+    i = 0;
+    pos = 0;
+    while (pos + RUN_HEADER_LEN <= len) {
+        int j, skip, changed;
+
+        skip = pSrc[pos] | (pSrc[pos + 1] << 8);
+        changed = pSrc[pos + 2] | (pSrc[pos + 3] << 8);
+        pos += RUN_HEADER_LEN;
+
+        i += skip;
+        for (j = 0; j < changed; j++) {
+            pDst[i + j] ^= pSrc[pos + j];
+        }
+        i += changed;
+        pos += changed;
+    }
+}
+
+/**
+ * Retrieve a frame from its position on the ring (0 being the oldest).
+ *
+ * @param  [ in]i The frame's position
+ */
+static inline rewindFrame* _getFrame(int i) {
+    return &rewindBuffer.pFrames[(rewindBuffer.first + i) % REWIND_MAX_FRAMES];
+}
+
+/** Drop the oldest frame, along with every frame encoded against it */
+static void _dropOldest() {
+    do {
+        rewindFrame *pFrame = _getFrame(0);
+
+        rewindBuffer.head = (rewindBuffer.head + pFrame->len)
+                % REWIND_BUFFER_LEN;
+        rewindBuffer.used -= pFrame->len;
+        rewindBuffer.first = (rewindBuffer.first + 1) % REWIND_MAX_FRAMES;
+        rewindBuffer.count--;
+    } while (rewindBuffer.count > 0 && !_getFrame(0)->isKeyframe);
+}
+
+/**
+ * Copy an encoded frame from the ring into pEncoded.
+ *
+ * @param  [ in]pFrame The frame
+ */
+static void _readFrame(rewindFrame *pFrame) {
+    uint32_t len;
+
+    len = pFrame->len;
+    if (pFrame->offset + len > REWIND_BUFFER_LEN) {
+        len = REWIND_BUFFER_LEN - pFrame->offset;
+    }
+    memcpy(rewindBuffer.pEncoded, rewindBuffer.pBuf + pFrame->offset, len);
+    memcpy(rewindBuffer.pEncoded + len, rewindBuffer.pBuf, pFrame->len - len);
+}
+
+/** Alloc the rewind buffer */
+err initRewind() {
+    rewindBuffer.pBuf = malloc(REWIND_BUFFER_LEN);
+    ASSERT(rewindBuffer.pBuf, ERR_OOM);
+    rewindBuffer.pEncoded = malloc(MAX_ENCODED_LEN);
+    ASSERT(rewindBuffer.pEncoded, ERR_OOM);
+    /* Zero the snapshots, so their padding is never seen as a change */
+    rewindBuffer.pCur = calloc(1, sizeof(snapshotCtx));
+    ASSERT(rewindBuffer.pCur, ERR_OOM);
+    rewindBuffer.pKeyframe = calloc(1, sizeof(snapshotCtx));
+    ASSERT(rewindBuffer.pKeyframe, ERR_OOM);
+
+    resetRewind();
+
+    return ERR_OK;
+}
+
+/** Release the rewind buffer */
+void freeRewind() {
+    free(rewindBuffer.pBuf);
+    free(rewindBuffer.pEncoded);
+    free(rewindBuffer.pCur);
+    free(rewindBuffer.pKeyframe);
+    memset(&rewindBuffer, 0x0, sizeof(rewindCtx));
+}
+
+/** Drop every captured frame */
+void resetRewind() {
+    rewindBuffer.head = 0;
+    rewindBuffer.used = 0;
+    rewindBuffer.first = 0;
+    rewindBuffer.count = 0;
+    rewindBuffer.sinceKeyframe = 0;
+}
+
+/** Store the current frame, dropping the oldest ones if necessary */
+err captureRewindFrame() {
+    rewindFrame *pFrame;
+    uint32_t len, tail, tmp;
+    int isKeyframe;
+
+    if (rewindBuffer.pBuf == 0) {
+        return ERR_OK;
+    }
+
+    takeSnapshot(rewindBuffer.pCur);
+
+    isKeyframe = (rewindBuffer.count == 0
+            || rewindBuffer.sinceKeyframe >= REWIND_KEYFRAME_INTERVAL);
+    if (isKeyframe) {
+        len = _encode(rewindBuffer.pEncoded, rewindBuffer.pCur, 0);
+    }
+    else {
+        len = _encode(rewindBuffer.pEncoded, rewindBuffer.pCur
+                , rewindBuffer.pKeyframe);
+    }
+
+    while (rewindBuffer.count > 0
+            && (rewindBuffer.count == REWIND_MAX_FRAMES
+                || rewindBuffer.used + len > REWIND_BUFFER_LEN)) {
+        _dropOldest();
+    }
+    if (rewindBuffer.count == 0 && !isKeyframe) {
+        /* The frame's keyframe got dropped, so encode it by itself */
+        isKeyframe = 1;
+        len = _encode(rewindBuffer.pEncoded, rewindBuffer.pCur, 0);
+    }
+
+    if (isKeyframe) {
+        memcpy(rewindBuffer.pKeyframe, rewindBuffer.pCur, sizeof(snapshotCtx));
+        rewindBuffer.sinceKeyframe = 0;
+    }
+    rewindBuffer.sinceKeyframe++;
+
+    /* Copy the frame into the ring, wrapping around its end */
+    tail = (rewindBuffer.head + rewindBuffer.used) % REWIND_BUFFER_LEN;
+    tmp = len;
+    if (tail + tmp > REWIND_BUFFER_LEN) {
+        tmp = REWIND_BUFFER_LEN - tail;
+    }
+    memcpy(rewindBuffer.pBuf + tail, rewindBuffer.pEncoded, tmp);
+    memcpy(rewindBuffer.pBuf, rewindBuffer.pEncoded + tmp, len - tmp);
+
+    pFrame = _getFrame(rewindBuffer.count);
+    pFrame->offset = tail;
+    pFrame->len = len;
+    pFrame->isKeyframe = (uint8_t)isKeyframe;
+    rewindBuffer.used += len;
+    rewindBuffer.count++;
+
+    return ERR_OK;
+}
+
+/**
+ * Go back a single frame, restoring the playstate to how it was on the
+ * previous capture. If only a single frame is left, it's restored but kept.
+ */
+err rewindStep() {
+    rewindFrame *pFrame;
+    int i, key;
+
+    if (rewindBuffer.count == 0) {
+        return ERR_OK;
+    }
+
+    if (rewindBuffer.count > 1) {
+        /* Drop the latest frame */
+        rewindBuffer.count--;
+        rewindBuffer.used -= _getFrame(rewindBuffer.count)->len;
+    }
+    i = rewindBuffer.count - 1;
+
+    /* Decode the frame's keyframe, so the following captures may be encoded
+     * against it */
+    key = i;
+    while (!_getFrame(key)->isKeyframe) {
+        key--;
+    }
+    pFrame = _getFrame(key);
+    _readFrame(pFrame);
+    memset(rewindBuffer.pKeyframe, 0x0, sizeof(snapshotCtx));
+    _decode(rewindBuffer.pKeyframe, rewindBuffer.pEncoded, pFrame->len);
+    rewindBuffer.sinceKeyframe = i - key + 1;
+
+    memcpy(rewindBuffer.pCur, rewindBuffer.pKeyframe, sizeof(snapshotCtx));
+    if (key != i) {
+        pFrame = _getFrame(i);
+        _readFrame(pFrame);
+        _decode(rewindBuffer.pCur, rewindBuffer.pEncoded, pFrame->len);
+    }
+
+    return restoreSnapshot(rewindBuffer.pCur, SNAP_ALL);
+}
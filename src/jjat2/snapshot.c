@@ -0,0 +1,195 @@
+/**
+ * @file src/jjat2/snapshot.c
+ *
+ * Store the whole playstate in memory, so it may be later restored without
+ * reloading the level from disk.
+ */
+#include <base/error.h>
+#include <base/game.h>
+#include <base/replay.h>
+
+#include <GFraMe/gfmCamera.h>
+#include <GFraMe/gfmGroup.h>
+#include <GFraMe/gfmSprite.h>
+
+#include <jjat2/camera.h>
+#include <jjat2/checkpoint.h>
+#include <jjat2/entity.h>
+#include <jjat2/events/signal.h>
+#include <jjat2/fx_group.h>
+#include <jjat2/hitbox.h>
+#include <jjat2/playstate.h>
+#include <jjat2/snapshot.h>
+#include <jjat2/teleport.h>
+#include <jjat2/ui.h>
+
+#include <string.h>
+
+/**
+ * Store an entity and its sprite
+ *
+ * @param  [out]pSnap The entity's snapshot
+ * @param  [ in]pEnt  The entity
+ */
+static void _saveEntity(entitySnapshot *pSnap, entityCtx *pEnt) {
+    memcpy(&pSnap->ent, pEnt, sizeof(entityCtx));
+    getSpriteState(&pSnap->spr, pEnt->pSelf);
+}
+
+/**
+ * Restore an entity and its sprite. Since every entity keeps the same sprite
+ * while the level is loaded, the entity's pointers stay valid.
+ *
+ * The entity's animation is played again from its start, displaying the stored
+ * frame until the animation's next frame.
+ *
+ * @param  [ in]pEnt  The entity
+ * @param  [ in]pSnap The entity's snapshot
+ */
+static err _restoreEntity(entityCtx *pEnt, entitySnapshot *pSnap) {
+    memcpy(pEnt, &pSnap->ent, sizeof(entityCtx));
+    if (pEnt->currentAnimation < pEnt->maxAnimation) {
+        err erv;
+
+        erv = setEntityAnimation(pEnt, pEnt->currentAnimation, 1/*force*/);
+        ASSERT(erv == ERR_OK, erv);
+    }
+    return setSpriteState(pEnt->pSelf, &pSnap->spr);
+}
+
+/**
+ * Store the current playstate.
+ *
+ * @param  [out]pSnap The snapshot
+ */
+void takeSnapshot(snapshotCtx *pSnap) {
+    int i;
+
+    pSnap->level = playstate.level;
+
+    _saveEntity(&pSnap->swordy, &playstate.swordy);
+    _saveEntity(&pSnap->gunny, &playstate.gunny);
+    for (i = 0; i < playstate.entityCount; i++) {
+        _saveEntity(&pSnap->entities[i], &playstate.entities[i]);
+    }
+    pSnap->entityCount = playstate.entityCount;
+
+    /* The teleport target is spawned again by the teleport module itself */
+    pSnap->fxCount = (uint16_t)saveFx(pSnap->fx, MAX_FX_NUM
+            , teleport.pCurEffect);
+    memcpy(&pSnap->teleport, &teleport, sizeof(teleportCtx));
+    if (teleport.pCurEffect != 0) {
+        gfmSprite *pEffect;
+
+        gfmGroup_getNodeSprite(&pEffect, teleport.pCurEffect);
+        getSpriteState(&pSnap->teleportSpr, pEffect);
+    }
+
+    memcpy(pSnap->data, playstate.data, sizeof(playstate.data));
+    memcpy(pSnap->hitboxes, hitboxes.states, sizeof(hitboxes.states));
+    pSnap->hitboxesUsed = hitboxes.used;
+    pSnap->hitboxesTmpUsed = hitboxes.tmpUsed;
+    pSnap->lastTouch = playstate.lastTouch;
+    pSnap->flags = playstate.flags;
+
+    pSnap->sessionFlags = game.sessionFlags;
+    memcpy(&pSnap->checkpoint, &checkpoint.data, sizeof(leveltransitionData));
+    memcpy(&pSnap->signals, &signalBus.state, sizeof(signalState));
+
+    gfmCamera_getPosition(&pSnap->cameraX, &pSnap->cameraY, game.pCamera);
+    pSnap->cameraTween = getCameraTween();
+    pSnap->uiControl = ui.control;
+
+    pSnap->hash = getSimulationHash();
+}
+
+/**
+ * Check whether a snapshot may be restored (i.e., whether it was taken on the
+ * currently loaded level).
+ *
+ * @param  [ in]pSnap The snapshot
+ * @return            1 if valid, 0 otherwise
+ */
+int isSnapshotValid(snapshotCtx *pSnap) {
+    return pSnap->level != LVL_NONE && pSnap->level == playstate.level;
+}
+
+/**
+ * Restore the playstate from a snapshot. If every part gets restored, the
+ * simulation's hash is checked against the one from when the snapshot was
+ * taken, and ERR_SNAPSHOTMISMATCH is returned if they differ.
+ *
+ * @param  [ in]pSnap The snapshot
+ * @param  [ in]parts Bitmask of snapshotPart, selecting what gets restored
+ */
+err restoreSnapshot(snapshotCtx *pSnap, int parts) {
+    err erv;
+    int i;
+
+    ASSERT(isSnapshotValid(pSnap), ERR_ARGUMENTBAD);
+
+    if (parts & SNAP_PLAYERS) {
+        erv = _restoreEntity(&playstate.swordy, &pSnap->swordy);
+        ASSERT(erv == ERR_OK, erv);
+        erv = _restoreEntity(&playstate.gunny, &pSnap->gunny);
+        ASSERT(erv == ERR_OK, erv);
+    }
+
+    if (parts & SNAP_WORLD) {
+        for (i = 0; i < pSnap->entityCount; i++) {
+            erv = _restoreEntity(&playstate.entities[i], &pSnap->entities[i]);
+            ASSERT(erv == ERR_OK, erv);
+        }
+        playstate.entityCount = pSnap->entityCount;
+
+        erv = restoreFx(pSnap->fx, pSnap->fxCount);
+        ASSERT(erv == ERR_OK, erv);
+        /* restoreFx already removed the previous target's effect */
+        resetTeleporterTarget();
+        if (pSnap->teleport.pCurEffect != 0
+                && pSnap->teleport.pTarget != 0) {
+            erv = teleporterTargetEntity(pSnap->teleport.pTarget);
+            ASSERT(erv == ERR_OK, erv);
+        }
+        else if (pSnap->teleport.pCurEffect != 0) {
+            erv = teleporterTargetPosition(pSnap->teleport.x
+                    , pSnap->teleport.y, pSnap->teleport.pos);
+            ASSERT(erv == ERR_OK, erv);
+        }
+        if (teleport.pCurEffect != 0) {
+            gfmSprite *pEffect;
+            gfmRV rv;
+
+            rv = gfmGroup_getNodeSprite(&pEffect, teleport.pCurEffect);
+            ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+            erv = setSpriteState(pEffect, &pSnap->teleportSpr);
+            ASSERT(erv == ERR_OK, erv);
+        }
+
+        memcpy(playstate.data, pSnap->data, sizeof(playstate.data));
+        erv = restoreHitboxes(pSnap->hitboxes, pSnap->hitboxesUsed
+                , pSnap->hitboxesTmpUsed);
+        ASSERT(erv == ERR_OK, erv);
+        playstate.lastTouch = pSnap->lastTouch;
+        playstate.flags = pSnap->flags;
+        memcpy(&signalBus.state, &pSnap->signals, sizeof(signalState));
+    }
+
+    if (parts & SNAP_SESSION) {
+        game.sessionFlags = pSnap->sessionFlags;
+        memcpy(&checkpoint.data, &pSnap->checkpoint
+                , sizeof(leveltransitionData));
+    }
+
+    if (parts & SNAP_VIEW) {
+        gfmCamera_setPosition(game.pCamera, pSnap->cameraX, pSnap->cameraY);
+        setCameraTween(pSnap->cameraTween);
+        ui.control = pSnap->uiControl;
+    }
+
+    /* Restoring everything must bring back the exact same state */
+    ASSERT((parts & SNAP_ALL) != SNAP_ALL || getSimulationHash() == pSnap->hash
+            , ERR_SNAPSHOTMISMATCH);
+
+    return ERR_OK;
+}
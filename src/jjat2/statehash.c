@@ -0,0 +1,86 @@
+/**
+ * @file src/jjat2/statehash.c
+ *
+ * Hash of every simulation-relevant state, used to check whether a replay
+ * diverged from its recording.
+ */
+#include <base/game.h>
+#include <base/hash.h>
+#include <base/replay.h>
+
+#include <GFraMe/gfmSprite.h>
+
+#include <jjat2/camera.h>
+#include <jjat2/checkpoint.h>
+#include <jjat2/entity.h>
+#include <jjat2/events/signal.h>
+#include <jjat2/fx_group.h>
+#include <jjat2/hitbox.h>
+#include <jjat2/playstate.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Accumulate an entity's physical and animation state into a hash.
+ *
+ * @param  [ in]hash The current hash
+ * @param  [ in]pEnt The entity
+ * @return           The updated hash
+ */
+static uint32_t _hashEntity(uint32_t hash, entityCtx *pEnt) {
+    double vx, vy;
+    int x, y;
+
+    gfmSprite_getPosition(&x, &y, pEnt->pSelf);
+    /* Velocities are hashed bit by bit, so even rounding differences are
+     * detected */
+    gfmSprite_getVelocity(&vx, &vy, pEnt->pSelf);
+
+    hash = hashInt(hash, x);
+    hash = hashInt(hash, y);
+    hash = hashBuf(hash, &vx, sizeof(vx));
+    hash = hashBuf(hash, &vy, sizeof(vy));
+#if defined(JJAT_FIXED_PHYSICS)
+    /* The sub-pixel position also affects the following frames */
+    hash = hashInt(hash, pEnt->fx);
+    hash = hashInt(hash, pEnt->fy);
+#endif /* JJAT_FIXED_PHYSICS */
+    hash = hashInt(hash, pEnt->flags);
+    hash = hashInt(hash, pEnt->jumpGrace);
+    hash = hashInt(hash, pEnt->currentAnimation);
+    /* Gameplay depends on the animation's frame */
+    return hashSpriteAnimation(hash, pEnt->pSelf);
+}
+
+/**
+ * Calculate a hash of every simulation-relevant state (i.e., anything that
+ * may change how the following frames play out).
+ */
+uint32_t getSimulationHash() {
+    leveltransitionData *pData;
+    uint32_t hash;
+    int i;
+
+    hash = HASH_INIT;
+    hash = hashInt(hash, game.currentState);
+    hash = hashInt(hash, game.sessionFlags);
+    hash = hashBuf(hash, &signalBus.state, sizeof(signalState));
+
+    hash = _hashEntity(hash, &playstate.swordy);
+    hash = _hashEntity(hash, &playstate.gunny);
+    hash = hashInt(hash, playstate.entityCount);
+    for (i = 0; i < playstate.entityCount; i++) {
+        hash = _hashEntity(hash, &playstate.entities[i]);
+    }
+
+    hash = hashFx(hash);
+    hash = hashHitboxes(hash);
+    hash = hashCamera(hash);
+
+    pData = &checkpoint.data;
+    hash = hashInt(hash, pData->level);
+    hash = hashInt(hash, pData->tgtX);
+    hash = hashInt(hash, pData->tgtY);
+    return hashInt(hash, pData->dir);
+}
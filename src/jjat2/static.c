@@ -1,38 +1,69 @@
 /**
  * @file src/jjat2/static.c
  *
- * Declare all static variables/contexts.
+ * Declare all static variables/contexts. Those belonging to the simulation are
+ * thread-local (see base/simulation.h).
  */
+#include <base/simulation.h>
+
+#include <jjat2/bot.h>
 #include <jjat2/checkpoint.h>
+#include <jjat2/events/signal.h>
+#include <jjat2/floorspan.h>
 #include <jjat2/fx_group.h>
 #include <jjat2/leveltransition.h>
 #include <jjat2/hitbox.h>
+#include <jjat2/netplay.h>
 #include <jjat2/playstate.h>
+#include <jjat2/rewind.h>
+#include <jjat2/snapshot.h>
 #include <jjat2/teleport.h>
+#include <jjat2/tilequery.h>
 #include <jjat2/ui.h>
 
 #include <string.h>
 
 /** The checkpoint context */
-checkpointCtx checkpoint;
+SIM_LOCAL checkpointCtx checkpoint;
 
 /** The UI context */
-uiCtx ui;
+SIM_LOCAL uiCtx ui;
 
 /** The hitbox context */
-hitboxesCtx hitboxes;
+SIM_LOCAL hitboxesCtx hitboxes;
 
 /** Animation for the level transition */
-leveltransitionCtx lvltransition;
+SIM_LOCAL leveltransitionCtx lvltransition;
 
 /** The game's playstate */
-playstateCtx playstate;
+SIM_LOCAL playstateCtx playstate;
+
+/** Floor spans of the current level */
+SIM_LOCAL floorSpansCtx floorSpans;
+
+/** Signals of the current level */
+SIM_LOCAL signalBusCtx signalBus;
+
+/** Tile types of the current level */
+SIM_LOCAL tileTypesCtx tileTypes;
 
 /** The group of effects/hitboxes */
-gfmGroup *fx;
+SIM_LOCAL gfmGroup *fx;
 
 /** The current target (if an entity) */
-teleportCtx teleport;
+SIM_LOCAL teleportCtx teleport;
+
+/** The game's snapshots */
+SIM_LOCAL snapshotsCtx snapshots;
+
+/** The rewind buffer */
+SIM_LOCAL rewindCtx rewindBuffer;
+
+/** The netplay session */
+SIM_LOCAL netplayCtx netplay;
+
+/** The bot stepping the simulation */
+SIM_LOCAL botCtx bot;
 
 /** Initialize the uninitialized 'local globals' (i.e., the ones defined for the
  * game itself, and not for the template)  with all-zeros. */
@@ -44,5 +75,12 @@ void zeroizeGameGlobalCtx() {
     memset(&lvltransition, 0x0, sizeof(leveltransitionCtx));
     memset(&ui, 0x0, sizeof(uiCtx));
     memset(&checkpoint, 0x0, sizeof(checkpointCtx));
+    memset(&snapshots, 0x0, sizeof(snapshotsCtx));
+    memset(&rewindBuffer, 0x0, sizeof(rewindCtx));
+    memset(&netplay, 0x0, sizeof(netplayCtx));
+    memset(&bot, 0x0, sizeof(botCtx));
+    memset(&floorSpans, 0x0, sizeof(floorSpansCtx));
+    memset(&signalBus, 0x0, sizeof(signalBusCtx));
+    memset(&tileTypes, 0x0, sizeof(tileTypesCtx));
 }
 
@@ -42,7 +42,7 @@ void resetTeleporterTarget() {
 static void cleanPreviousTarget() {
     if (teleport.pCurEffect) {
         /* TODO Spawn a trasitioning effect? */
-        gfmGroup_removeNode(teleport.pCurEffect);
+        removeFx(teleport.pCurEffect);
     }
     resetTeleporterTarget();
 }
@@ -64,6 +64,9 @@ err teleporterTargetPosition(int x, int y, teleportPosition pos) {
     pEffect = spawnFx(x + TPFX_X, y + TPFX_Y, TPFX_W, TPFX_H, 0/*dir*/, 0/*ttl*/
             , FX_TELEPORT_TARGET, T_FX);
     ASSERT(pEffect, ERR_GFMERR);
+    teleport.x = x;
+    teleport.y = y;
+    teleport.pos = pos;
     if (pos == TP_RIGHT) {
         gfmSprite_setOffset(pEffect, TPFX_OFFX_R, TPFX_OFFY);
     }
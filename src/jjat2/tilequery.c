@@ -0,0 +1,494 @@
+/**
+ * @file src/jjat2/tilequery.c
+ *
+ * Query the level's tilemap (i.e., playstate.pMap) directly, without going
+ * through the quadtree.
+ *
+ * The type table is filled from GFraMe's own lookup, but only once for each
+ * distinct tile (and only when a level is loaded).
+ *
+ * Both the raycast and the sweep walk the tile grid (a DDA), visiting only the
+ * tiles actually crossed, from the closest to the farthest one. The sweep runs
+ * during the simulation, so it only uses integers (see sweepTiles).
+ */
+#include <base/game.h>
+
+#include <conf/type.h>
+
+#include <jjat2/playstate.h>
+#include <jjat2/tilequery.h>
+#include <jjat2/tileview.h>
+
+#include <GFraMe/gfmError.h>
+#include <GFraMe/gfmTilemap.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Time set on an axis that never crosses any boundary */
+#define NEVER           2.0
+
+/** Type set on the table for tiles not looked up yet */
+#define UNKNOWN_TYPE    0xff
+
+/** Movement of a box along a single axis. Times are kept as integers, scaled
+ * so the whole displacement takes exactly the sweep's duration (see
+ * sweepTiles) */
+struct stSweepAxis {
+    /** Time until the leading edge crosses the boundary */
+    int64_t time;
+    /** Time taken to move a single pixel along the axis (negative if moving
+     * backwards, 0 if not moving) */
+    int64_t scale;
+    /** Position of the box's leading edge, in pixels */
+    int edge;
+    /** The displacement along the axis, in pixels */
+    int delta;
+    /** Next tile boundary crossed by the leading edge, in pixels */
+    int boundary;
+    /** Tile entered when the boundary is crossed */
+    int tile;
+};
+typedef struct stSweepAxis sweepAxis;
+
+/**
+ * Convert a position into the tile that contains it.
+ *
+ * @param  [ in]pos The position, in pixels
+ */
+static int _toTile(double pos) {
+    int tile;
+
+    /* Casting rounds towards zero, but negative positions must be rounded
+     * down */
+    tile = (int)(pos / TILE_DIMENSION);
+    if (tile * TILE_DIMENSION > pos) {
+        tile--;
+    }
+
+    return tile;
+}
+
+/**
+ * Convert the end of an interval (exclusive) into the last tile it covers.
+ *
+ * @param  [ in]pos The interval's end, in pixels
+ */
+static int _toLastTile(double pos) {
+    int tile;
+
+    tile = _toTile(pos);
+    if (tile * TILE_DIMENSION == pos) {
+        tile--;
+    }
+
+    return tile;
+}
+
+/**
+ * Convert a scaled position into the tile that contains it.
+ *
+ * @param  [ in]pos   The position, in pixels times scale
+ * @param  [ in]scale How many units there are in a pixel
+ */
+static int _toScaledTile(int64_t pos, int64_t scale) {
+    int64_t div;
+
+    div = scale * TILE_DIMENSION;
+    if (pos >= 0) {
+        return (int)(pos / div);
+    }
+    return (int)((pos + 1) / div - 1);
+}
+
+/**
+ * Check whether a tile type matches a filter.
+ *
+ * @param  [ in]type   The tile's type
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ */
+static int _isMatch(int type, int filter) {
+    if (type == 0) {
+        return 0;
+    }
+    else if (filter == TQ_SOLID) {
+        return (type & T_BASE_MASK) == T_FLOOR && (type != T_BLUE_PLATFORM
+                || (game.sessionFlags & SF_BLUE_ACTIVE));
+    }
+    return filter == TQ_ANY || (type & T_BASE_MASK) == (filter & T_BASE_MASK);
+}
+
+/**
+ * Fill a hit (if requested).
+ *
+ * @param  [out]pHit     The hit
+ * @param  [ in]tileX    The tile's position, in tiles
+ * @param  [ in]tileY    The tile's position, in tiles
+ * @param  [ in]x        Where the tile was touched, in pixels
+ * @param  [ in]y        Where the tile was touched, in pixels
+ * @param  [ in]type     The tile's type
+ * @param  [ in]vertical Whether the tile was touched from above or below
+ */
+static void _setHit(tileHit *pHit, int tileX, int tileY, int x, int y
+        , int type, int vertical) {
+    if (pHit) {
+        pHit->tileX = tileX;
+        pHit->tileY = tileY;
+        pHit->x = x;
+        pHit->y = y;
+        pHit->type = type;
+        pHit->vertical = vertical;
+    }
+}
+
+/** Build the type table for the currently loaded tilemap (playstate.pMap),
+ * after its view (playstate.mapView) got synced */
+err buildTileTypes() {
+    tileView *pView;
+    gfmRV rv;
+    int i, len, max;
+
+    pView = &playstate.mapView;
+    len = pView->width * pView->height;
+
+    max = -1;
+    for (i = 0; i < len; i++) {
+        if (pView->pTiles[i] != TILE_VIEW_EMPTY && pView->pTiles[i] > max) {
+            max = pView->pTiles[i];
+        }
+    }
+
+    if (max + 1 > tileTypes.typesLen) {
+        uint8_t *pTypes;
+
+        pTypes = realloc(tileTypes.pTypes, sizeof(uint8_t) * (max + 1));
+        ASSERT(pTypes, ERR_OOM);
+        tileTypes.pTypes = pTypes;
+        tileTypes.typesLen = max + 1;
+    }
+    memset(tileTypes.pTypes, UNKNOWN_TYPE, sizeof(uint8_t) * (max + 1));
+
+    for (i = 0; i < len; i++) {
+        int tile, type;
+
+        tile = pView->pTiles[i];
+        if (tile == TILE_VIEW_EMPTY || tileTypes.pTypes[tile] != UNKNOWN_TYPE) {
+            continue;
+        }
+
+        rv = gfmTilemap_getTypeAt(&type, playstate.pMap
+                , (i % pView->width) * TILE_DIMENSION
+                , (i / pView->width) * TILE_DIMENSION);
+        if (rv != GFMRV_OK) {
+            type = 0;
+        }
+        ASSERT(type >= 0 && type < UNKNOWN_TYPE, ERR_INVALIDTYPE);
+        tileTypes.pTypes[tile] = (uint8_t)type;
+    }
+
+    tileTypes.count = max + 1;
+
+    return ERR_OK;
+}
+
+/** Release the type table */
+void freeTileTypes() {
+    free(tileTypes.pTypes);
+    memset(&tileTypes, 0x0, sizeof(tileTypesCtx));
+}
+
+/**
+ * Retrieve the type of a tile.
+ *
+ * @param  [ in]tileX The tile's position, in tiles
+ * @param  [ in]tileY The tile's position, in tiles
+ * @return            The tile's type (0 if none or outside the tilemap)
+ */
+int getTileType(int tileX, int tileY) {
+    int tile;
+
+    /* Every tile on the level was looked up when the table was built, so this
+     * only has to skip empty tiles */
+    tile = getTileViewAt(&playstate.mapView, tileX, tileY);
+    if (tile == TILE_VIEW_EMPTY) {
+        return 0;
+    }
+
+    return tileTypes.pTypes[tile];
+}
+
+/**
+ * Check whether the tile on a given position matches the filter.
+ *
+ * @param  [ in]x      The position, in pixels
+ * @param  [ in]y      The position, in pixels
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ * @return             1 if there's a matching tile, 0 otherwise
+ */
+int isTileAt(int x, int y, int filter) {
+    return _isMatch(getTileType(_toTile(x), _toTile(y)), filter);
+}
+
+/**
+ * Walk every tile crossed by a segment (from its first point to the last),
+ * stopping on the first one that matches the filter.
+ *
+ * @param  [out]pHit   The first matching tile (may be NULL)
+ * @param  [ in]x0     The segment's first point, in pixels
+ * @param  [ in]y0     The segment's first point, in pixels
+ * @param  [ in]x1     The segment's last point, in pixels
+ * @param  [ in]y1     The segment's last point, in pixels
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ * @return             1 if a tile was found, 0 otherwise
+ */
+int raycastTiles(tileHit *pHit, int x0, int y0, int x1, int y1, int filter) {
+    double dx, dy, t, tDeltaX, tDeltaY, tMaxX, tMaxY;
+    int endX, endY, stepX, stepY, tileX, tileY, vertical;
+
+    tileX = _toTile(x0);
+    tileY = _toTile(y0);
+    endX = _toTile(x1);
+    endY = _toTile(y1);
+    dx = x1 - x0;
+    dy = y1 - y0;
+
+    /* Time (within [0, 1]) until the next boundary on each axis, and the time
+     * between two boundaries */
+    if (dx > 0) {
+        stepX = 1;
+        tMaxX = ((tileX + 1) * TILE_DIMENSION - x0) / dx;
+        tDeltaX = TILE_DIMENSION / dx;
+    }
+    else if (dx < 0) {
+        stepX = -1;
+        tMaxX = (tileX * TILE_DIMENSION - x0) / dx;
+        tDeltaX = -TILE_DIMENSION / dx;
+    }
+    else {
+        stepX = 0;
+        tMaxX = NEVER;
+        tDeltaX = 0;
+    }
+    if (dy > 0) {
+        stepY = 1;
+        tMaxY = ((tileY + 1) * TILE_DIMENSION - y0) / dy;
+        tDeltaY = TILE_DIMENSION / dy;
+    }
+    else if (dy < 0) {
+        stepY = -1;
+        tMaxY = (tileY * TILE_DIMENSION - y0) / dy;
+        tDeltaY = -TILE_DIMENSION / dy;
+    }
+    else {
+        stepY = 0;
+        tMaxY = NEVER;
+        tDeltaY = 0;
+    }
+
+    t = 0;
+    vertical = 0;
+    while (1) {
+        int type;
+
+        type = getTileType(tileX, tileY);
+        if (_isMatch(type, filter)) {
+            _setHit(pHit, tileX, tileY, x0 + (int)(dx * t), y0 + (int)(dy * t)
+                    , type, vertical);
+            return 1;
+        }
+
+        if (tileX == endX && tileY == endY) {
+            break;
+        }
+        else if (tMaxX < tMaxY) {
+            t = tMaxX;
+            tMaxX += tDeltaX;
+            tileX += stepX;
+            vertical = 0;
+        }
+        else {
+            t = tMaxY;
+            tMaxY += tDeltaY;
+            tileY += stepY;
+            vertical = 1;
+        }
+
+        if (t > 1.0) {
+            /* Rounding errors walked past the last point */
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Prepare moving a box along an axis.
+ *
+ * @param  [out]pAxis    The axis
+ * @param  [ in]pos      The box's position on the axis, in pixels
+ * @param  [ in]dim      The box's dimension on the axis, in pixels
+ * @param  [ in]delta    The displacement on the axis, in pixels
+ * @param  [ in]duration The sweep's duration (a multiple of delta)
+ */
+static void _initSweepAxis(sweepAxis *pAxis, int pos, int dim, int delta
+        , int64_t duration) {
+    pAxis->delta = delta;
+
+    if (delta > 0) {
+        pAxis->edge = pos + dim;
+        pAxis->boundary = (_toScaledTile(pos + dim - 1, 1) + 1)
+                * TILE_DIMENSION;
+        pAxis->tile = pAxis->boundary / TILE_DIMENSION;
+    }
+    else if (delta < 0) {
+        pAxis->edge = pos;
+        pAxis->boundary = _toScaledTile(pos, 1) * TILE_DIMENSION;
+        pAxis->tile = pAxis->boundary / TILE_DIMENSION - 1;
+    }
+    else {
+        pAxis->scale = 0;
+        pAxis->time = duration;
+        return;
+    }
+    pAxis->scale = duration / delta;
+    pAxis->time = (pAxis->boundary - pAxis->edge) * pAxis->scale;
+}
+
+/**
+ * Advance an axis to its following boundary.
+ *
+ * @param  [ in]pAxis The axis
+ */
+static void _nextSweepAxis(sweepAxis *pAxis) {
+    if (pAxis->delta > 0) {
+        pAxis->boundary += TILE_DIMENSION;
+        pAxis->tile++;
+    }
+    else {
+        pAxis->boundary -= TILE_DIMENSION;
+        pAxis->tile--;
+    }
+    pAxis->time = (pAxis->boundary - pAxis->edge) * pAxis->scale;
+}
+
+/**
+ * Retrieve the tiles covered by a box, along the axis perpendicular to the one
+ * that crossed a boundary. The box is considered to be slightly past that
+ * instant, so tiles entered through both axes at the same time aren't missed.
+ *
+ * @param  [out]pFirst   The first tile covered
+ * @param  [out]pLast    The last tile covered
+ * @param  [ in]pos      The box's initial position on the axis, in pixels
+ * @param  [ in]dim      The box's dimension on the axis, in pixels
+ * @param  [ in]delta    The displacement on the axis, in pixels
+ * @param  [ in]t        The instant the boundary was crossed
+ * @param  [ in]duration The sweep's duration
+ */
+static void _getSweepSpan(int *pFirst, int *pLast, int pos, int dim, int delta
+        , int64_t t, int64_t duration) {
+    int64_t end, start;
+
+    start = pos * duration + delta * t;
+    end = start + dim * duration;
+    /* Moving backwards, a box exactly on a boundary is about to enter the
+     * previous tile. Moving forward, its end is about to enter the next one */
+    if (delta < 0) {
+        start--;
+    }
+    if (delta <= 0) {
+        end--;
+    }
+
+    *pFirst = _toScaledTile(start, duration);
+    *pLast = _toScaledTile(end, duration);
+}
+
+/**
+ * Move a box along a displacement, stopping on the first tile it touches that
+ * matches the filter. Tiles already overlapped by the box are ignored.
+ *
+ * Since this runs during the simulation, it must give the same result on every
+ * machine. So, instead of a time within [0, 1], the sweep takes |dx| * |dy|
+ * (ignoring any axis that doesn't move) and every instant is an integer.
+ *
+ * @param  [out]pHit   The first matching tile (may be NULL)
+ * @param  [ in]x      The box's position, in pixels
+ * @param  [ in]y      The box's position, in pixels
+ * @param  [ in]w      The box's dimensions, in pixels
+ * @param  [ in]h      The box's dimensions, in pixels
+ * @param  [ in]dx     The displacement, in pixels
+ * @param  [ in]dy     The displacement, in pixels
+ * @param  [ in]filter Base type (or TQ_ANY) of the tile
+ * @return             1 if a tile was found, 0 otherwise
+ */
+int sweepTiles(tileHit *pHit, int x, int y, int w, int h, int dx, int dy
+        , int filter) {
+    sweepAxis horz, vert;
+    int64_t duration;
+
+    duration = 1;
+    if (dx != 0) {
+        duration *= (dx > 0) ? dx : -dx;
+    }
+    if (dy != 0) {
+        duration *= (dy > 0) ? dy : -dy;
+    }
+
+    _initSweepAxis(&horz, x, w, dx, duration);
+    _initSweepAxis(&vert, y, h, dy, duration);
+
+    /* Touching a tile at the very end of the displacement isn't overlapping
+     * it, so only boundaries crossed before that are checked */
+    while (horz.time < duration || vert.time < duration) {
+        int64_t t;
+        int first, i, last;
+
+        if (horz.time <= vert.time) {
+            t = horz.time;
+            _getSweepSpan(&first, &last, y, h, dy, t, duration);
+
+            /* Check the column entered by the leading edge */
+            for (i = first; i <= last; i++) {
+                int px, type;
+
+                type = getTileType(horz.tile, i);
+                if (_isMatch(type, filter)) {
+                    px = horz.boundary;
+                    if (dx > 0) {
+                        px -= w;
+                    }
+                    _setHit(pHit, horz.tile, i, px
+                            , y + (int)(dy * t / duration), type
+                            , 0/*vertical*/);
+                    return 1;
+                }
+            }
+            _nextSweepAxis(&horz);
+        }
+        else {
+            t = vert.time;
+            _getSweepSpan(&first, &last, x, w, dx, t, duration);
+
+            /* Check the row entered by the leading edge */
+            for (i = first; i <= last; i++) {
+                int py, type;
+
+                type = getTileType(i, vert.tile);
+                if (_isMatch(type, filter)) {
+                    py = vert.boundary;
+                    if (dy > 0) {
+                        py -= h;
+                    }
+                    _setHit(pHit, i, vert.tile, x + (int)(dx * t / duration)
+                            , py, type, 1/*vertical*/);
+                    return 1;
+                }
+            }
+            _nextSweepAxis(&vert);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file src/jjat2/tileview.c
+ *
+ * A 16-bit tile-query view: a read-only copy of a tilemap's tiles.
+ */
+#include <base/error.h>
+
+#include <jjat2/playstate.h>
+#include <jjat2/tileview.h>
+
+#include <GFraMe/gfmError.h>
+#include <GFraMe/gfmTilemap.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Copy every tile from a tilemap into a view.
+ *
+ * @param  [ in]pView    The view
+ * @param  [ in]pTilemap The tilemap
+ */
+err syncTileView(tileView *pView, gfmTilemap *pTilemap) {
+    uint16_t *pTiles;
+    int *pData;
+    gfmRV rv;
+    int height, i, len, width;
+
+    rv = gfmTilemap_getData(&pData, pTilemap);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    rv = gfmTilemap_getDimension(&width, &height, pTilemap);
+    ASSERT(rv == GFMRV_OK, ERR_GFMERR);
+    width /= TILE_DIMENSION;
+    height /= TILE_DIMENSION;
+    len = width * height;
+
+    if (len > pView->len) {
+        pTiles = realloc(pView->pTiles, sizeof(uint16_t) * len);
+        ASSERT(pTiles, ERR_OOM);
+        pView->pTiles = pTiles;
+        pView->len = len;
+    }
+
+    for (i = 0; i < len; i++) {
+        if (pData[i] < 0) {
+            pView->pTiles[i] = TILE_VIEW_EMPTY;
+        }
+        else {
+            ASSERT(pData[i] < TILE_VIEW_EMPTY, ERR_INDEXOOB);
+            pView->pTiles[i] = (uint16_t)pData[i];
+        }
+    }
+
+    pView->width = width;
+    pView->height = height;
+
+    return ERR_OK;
+}
+
+/**
+ * Release a view.
+ *
+ * @param  [ in]pView The view
+ */
+void freeTileView(tileView *pView) {
+    free(pView->pTiles);
+    memset(pView, 0x0, sizeof(tileView));
+}
@@ -8,6 +8,7 @@
 #include <base/error.h>
 #include <base/game.h>
 #include <base/gfx.h>
+#include <base/hash.h>
 #include <conf/game.h>
 #include <GFraMe/gfmTilemap.h>
 #include <jjat2/ui.h>
@@ -85,7 +86,7 @@ void resetUI() {
  *
  * @param  [ in]title The title
  */
-void setMapTitle(char *title) {
+void setMapTitle(const char *title) {
     int i, offset;
 
     /* If necessary, offset to the bottom row */
@@ -206,6 +207,30 @@ void setGunnyLife(int cur, int max) {
     }
 }
 
+/**
+ * Accumulate everything that affects how the UI is rendered into a hash, so
+ * changes may be detected between frames.
+ *
+ * @param  [ in]hash The current hash
+ * @return           The updated hash
+ */
+uint32_t hashUI(uint32_t hash) {
+    uint32_t time;
+
+    time = ui.control & UI_TIME_MASK;
+    if (time >= UI_HIDE) {
+        /* Hidden, so nothing gets rendered */
+        return hash;
+    }
+    else if (time >= UI_DISPLAY && time < UI_WAIT) {
+        /* The UI stays still while waiting, so ignore the timer */
+        time = UI_DISPLAY;
+    }
+
+    hash = hashInt(hash, (ui.control & ~UI_TIME_MASK) | time);
+    return hashBuf(hash, ui.pData, sizeof(int) * TM_WIDTH * TM_HEIGHT);
+}
+
 /** Update the UI position */
 err updateUI() {
     uint32_t time;
@@ -0,0 +1,49 @@
+/**
+ * @file src/jjat2/world.c
+ *
+ * Every level in the world, as listed on conf/level_list.h.
+ */
+#include <base/error.h>
+
+#include <conf/level_list.h>
+
+#include <jjat2/world.h>
+
+#include <string.h>
+
+/** Path to one of a level's files */
+#define LEVEL_PATH(name, suffix) "levels/" name suffix
+/** Length of the path to one of a level's files */
+#define LEVEL_PATH_LEN(name, suffix) (sizeof(LEVEL_PATH(name, suffix)) - 1)
+
+/** Manifest of every level, indexed by its levelId (LVL_NONE is empty) */
+const levelManifest pLevels[LVL_COUNT] = {
+    { "", "", "", "", "", 0, 0, 0 }
+#define X(id, name, song) \
+  , { name, LEVEL_PATH(name, "_fg_tm.gfm"), LEVEL_PATH(name, "_bg_tm.gfm") \
+    , LEVEL_PATH(name, "_obj.gfm"), song, LEVEL_PATH_LEN(name, "_fg_tm.gfm") \
+    , LEVEL_PATH_LEN(name, "_bg_tm.gfm"), LEVEL_PATH_LEN(name, "_obj.gfm") }
+    LEVELS_LIST
+#undef X
+};
+
+/**
+ * Retrieve a level by its name.
+ *
+ * @param  [out]pId   The level
+ * @param  [ in]pName The level's name (e.g., "lab/awakening_passage")
+ */
+err getLevelId(levelId *pId, const char *pName) {
+    int i;
+
+    ASSERT(pName != 0, ERR_ARGUMENTBAD);
+
+    for (i = LVL_NONE + 1; i < LVL_COUNT; i++) {
+        if (strcmp(pLevels[i].pName, pName) == 0) {
+            *pId = (levelId)i;
+            return ERR_OK;
+        }
+    }
+
+    return ERR_INVALIDLEVELNAME;
+}
@@ -3,13 +3,17 @@
  */
 #include <base/collision.h>
 #include <base/error.h>
+#include <base/framepacer.h>
 #include <base/game.h>
 #include <base/gfx.h>
 #include <base/input.h>
 #include <base/loadstate.h>
 #include <base/mainloop.h>
+#include <base/perfoverlay.h>
+#include <base/replay.h>
 #include <base/resource.h>
 #include <base/sfx.h>
+#include <base/trace.h>
 
 #include <conf/state.h>
 
@@ -20,7 +24,9 @@
 #include <jjat2/fx_group.h>
 #include <jjat2/hitbox.h>
 #include <jjat2/leveltransition.h>
+#include <jjat2/netplay.h>
 #include <jjat2/playstate.h>
+#include <jjat2/rewind.h>
 #include <jjat2/static.h>
 #include <jjat2/ui.h>
 
@@ -40,6 +46,14 @@ err mainloop() {
     ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
     erv = initHitboxes();
     ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+#if defined(DEBUG)
+    erv = initRewind();
+    ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+#endif /* DEBUG */
+    if (game.flags & CMD_NETPLAY) {
+        erv = startNetplay();
+        ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+    }
 
     erv = initLoadstate(gfx.pSset8x8, 0/*offset*/);
     ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
@@ -48,8 +62,12 @@ err mainloop() {
     game.nextState = ST_PLAYSTATE;
 
     while (gfm_didGetQuitFlag(game.pCtx) != GFMRV_TRUE) {
+        uint64_t frameStart = traceBegin();
+
         /* Switch state */
         if (game.nextState != ST_NONE) {
+            uint64_t switchStart = traceBegin();
+
             switch (game.nextState) {
                 case ST_PLAYSTATE: erv = loadPlaystate(); break;
                 case ST_LEVELTRANSITION: erv = setupLeveltransition(); break;
@@ -60,9 +78,12 @@ err mainloop() {
 
             game.currentState = game.nextState;
             game.nextState = ST_NONE;
+            markFrameDirty();
+            traceEnd(switchStart, "switchState");
         }
 
-        /* Wait for an event */
+        /* Sleep through any slack, then wait for an event */
+        framePacerSleep();
         rv = gfm_handleEvents(game.pCtx);
         ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
 
@@ -70,9 +91,18 @@ err mainloop() {
         erv = updateDebugInput();
         ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
         handleDebugInput();
+        /* GIFs must record every frame, even if nothing changed */
+        if (gfm_didExportGif(game.pCtx) == GFMRV_FALSE) {
+            markFrameDirty();
+        }
 #endif
 
         while (DO_UPDATE()) {
+            uint64_t updateStart = traceBegin();
+
+            erv = updateResourceLoader();
+            ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+
             if (game.currentState != ST_LOADSTATE && isLoading()) {
                 startLoadstate();
             }
@@ -85,6 +115,7 @@ err mainloop() {
 
             rv = gfm_fpsCounterUpdateBegin(game.pCtx);
             ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
+            framePacerBeginUpdate();
 
             erv = updateInput();
             ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
@@ -92,6 +123,8 @@ err mainloop() {
 
             rv = gfm_getElapsedTime(&(game.elapsed), game.pCtx);
             ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
+            erv = replayFrameInput();
+            ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
 
             /* Update the current state */
             switch (game.currentState) {
@@ -101,14 +134,34 @@ err mainloop() {
                 default: {}
             }
             ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+            erv = replayFrameState();
+            ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+            /* Only the playstate checks whether anything changed on screen */
+            if (game.currentState != ST_PLAYSTATE) {
+                markFrameDirty();
+            }
 
+            framePacerEndUpdate();
+            perfOverlayEndUpdate();
             rv = gfm_fpsCounterUpdateEnd(game.pCtx);
             ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
+            traceEnd(updateStart, "update");
 
             DEBUG_STEP();
         }
 
         while (gfm_isDrawing(game.pCtx) == GFMRV_TRUE) {
+            uint64_t drawStart;
+
+            /* Keep the last frame if nothing changed since it was drawn. Note
+             * that, just like gfm_isUpdating, gfm_isDrawing consumes the
+             * pending frame, so this won't loop forever */
+            if (!framePacerShouldDraw()) {
+                continue;
+            }
+
+            drawStart = traceBegin();
+            framePacerBeginDraw();
             rv = gfm_drawBegin(game.pCtx);
             ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
 
@@ -134,14 +187,36 @@ err mainloop() {
 
             rv = gfm_drawRenderInfo(game.pCtx, 0, 0/*x*/, 24/*y*/, 0);
             ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
+            drawFramePacerInfo();
+            if (perf.visible) {
+                perfCounter pCounters[] = {
+                    {"ENT", playstate.entityCount, MAX_ENTITIES}
+                  , {"HITBX", hitboxes.used + hitboxes.tmpUsed, MAX_HITBOXES}
+                  , {"FX", getFxCount(), MAX_FX_NUM}
+                  , {"RBACK", netplay.resimulated, NETPLAY_MAX_ROLLBACK}
+                };
+                drawPerfOverlay(pCounters
+                        , sizeof(pCounters) / sizeof(pCounters[0]));
+            }
 
             rv = gfm_drawEnd(game.pCtx);
             ASSERT_TO(rv == GFMRV_OK, erv = ERR_GFMERR, __ret);
+
+            erv = framePacerEndDraw();
+            ASSERT_TO(erv == ERR_OK, NOOP(), __ret);
+            perfOverlayEndDraw();
+            traceEnd(drawStart, "draw");
         }
+
+        traceEnd(frameStart, "frame");
     }
 
     erv = ERR_OK;
 __ret:
+    stopNetplay();
+#if defined(DEBUG)
+    freeRewind();
+#endif /* DEBUG */
     freeHitboxes();
     freeUI();
     freeLeveltransition();